@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+    Single-producer/single-consumer sample FIFO feeding the spectrum analyser.
+
+    The audio thread pushes each block's channels; a background thread pulls
+    them for the FFT and sums the channels' power spectra. Channels aren't
+    mixed down here, since a mono sum cancels anything out of phase between
+    them (a pure side signal would read as silence). Both sides are
+    wait-free: juce::AbstractFifo only uses atomics, the storage is allocated
+    once at construction, and when the reader falls behind the writer drops
+    what doesn't fit rather than waiting.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <atomic>
+#include <vector>
+
+class AnalyserFifo
+{
+public:
+    /** Samples held per channel before pushes start dropping (about 0.7s at 48kHz). */
+    static constexpr int capacity = 1 << 15;
+
+    /** Channels beyond this many aren't analysed (7.1 fits). */
+    static constexpr int maxChannels = 8;
+
+    //==============================================================================
+    /** Audio thread: appends the first numChannels channels. Never blocks. */
+    template <typename SampleType>
+    void push (const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept
+    {
+        const int numSamples = buffer.getNumSamples();
+        numChannels = juce::jmin (numChannels, buffer.getNumChannels(), maxChannels);
+
+        if (numChannels <= 0 || numSamples <= 0)
+            return;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (numSamples, start1, size1, start2, size2);
+
+        // A channel that was pushed before but isn't now is written as silence, so
+        // every channel the reader sees lines up with the others
+        const int channelsToWrite = juce::jmax (numChannels, numWrittenChannels.load (std::memory_order_relaxed));
+
+        for (int ch = 0; ch < channelsToWrite; ++ch)
+        {
+            auto* channelStorage = storage.data() + (size_t) ch * capacity;
+            copyChannel (buffer, ch < numChannels ? ch : -1, 0, channelStorage + start1, size1);
+            copyChannel (buffer, ch < numChannels ? ch : -1, size1, channelStorage + start2, size2);
+        }
+
+        numWrittenChannels.store (channelsToWrite, std::memory_order_relaxed);
+        fifo.finishedWrite (size1 + size2);
+
+        if (size1 + size2 < numSamples)
+            droppedSamples.fetch_add (numSamples - size1 - size2, std::memory_order_relaxed);
+    }
+
+    //==============================================================================
+    /** Reader thread: copies up to maxSamples of each of the first numDestChannels
+        channels into dest and returns how many samples were read. Channels that
+        haven't been pushed read as silence.
+    */
+    int pull (float* const* dest, int numDestChannels, int maxSamples) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (maxSamples, start1, size1, start2, size2);
+
+        const int numChannels = juce::jmin (numDestChannels, getNumChannels());
+
+        for (int ch = 0; ch < numDestChannels; ++ch)
+        {
+            if (ch < numChannels)
+            {
+                const auto* channelStorage = storage.data() + (size_t) ch * capacity;
+                juce::FloatVectorOperations::copy (dest[ch], channelStorage + start1, size1);
+                juce::FloatVectorOperations::copy (dest[ch] + size1, channelStorage + start2, size2);
+            }
+            else
+            {
+                juce::FloatVectorOperations::clear (dest[ch], size1 + size2);
+            }
+        }
+
+        fifo.finishedRead (size1 + size2);
+        return size1 + size2;
+    }
+
+    int getNumReady() const noexcept                 { return fifo.getNumReady(); }
+
+    /** The most channels any push has carried; the others are silent. */
+    int getNumChannels() const noexcept              { return numWrittenChannels.load (std::memory_order_acquire); }
+
+    /** Samples pushed while the FIFO was full, since construction. */
+    int getNumDroppedSamples() const noexcept        { return droppedSamples.load (std::memory_order_relaxed); }
+
+private:
+    // sourceChannel -1 writes silence
+    static void copyChannel (const juce::AudioBuffer<float>& buffer, int sourceChannel, int sourceStart,
+                             float* dest, int numSamples) noexcept
+    {
+        if (numSamples <= 0)
+            return;
+
+        if (sourceChannel < 0)
+            juce::FloatVectorOperations::clear (dest, numSamples);
+        else
+            juce::FloatVectorOperations::copy (dest, buffer.getReadPointer (sourceChannel, sourceStart), numSamples);
+    }
+
+    // Double precision blocks are narrowed sample by sample
+    static void copyChannel (const juce::AudioBuffer<double>& buffer, int sourceChannel, int sourceStart,
+                             float* dest, int numSamples) noexcept
+    {
+        if (numSamples <= 0)
+            return;
+
+        if (sourceChannel < 0)
+        {
+            juce::FloatVectorOperations::clear (dest, numSamples);
+            return;
+        }
+
+        const auto* source = buffer.getReadPointer (sourceChannel, sourceStart);
+
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = (float) source[i];
+    }
+
+    juce::AbstractFifo fifo { capacity };
+    std::vector<float> storage = std::vector<float> ((size_t) capacity * maxChannels);
+    std::atomic<int> numWrittenChannels { 0 };   // Only grows, and only on the audio thread
+    std::atomic<int> droppedSamples { 0 };
+};
@@ -0,0 +1,266 @@
+/*
+  ==============================================================================
+
+    Compact binary encoding of the plugin state.
+
+    Hosts call getStateInformation for every undo snapshot and autosave, so the
+    state is written as a small fixed-layout block instead of going through a
+    ValueTree and XML:
+
+        uint32  magic ('FFST')
+        uint16  format version
+        uint16  number of entries
+        entries: uint32 hash of the parameter ID, float32 value
+        chunks (optional): uint32 chunk ID, uint32 size, size bytes
+
+    All little-endian. Values are stored in the parameter's own units (not
+    normalised), so ranges can change between versions without shifting saved
+    values, and entries are matched by ID hash, so parameters can be added,
+    removed or reordered: unknown entries are skipped and parameters missing
+    from the data go back to their defaults. When a parameter's values change
+    meaning (e.g. choices inserted), the version goes up and an upgrader maps
+    values saved by older versions. A parameter that moved to a new ID names
+    its legacy ID, which it's loaded from when the data predates the move.
+    Writing needs no heap allocation apart from growing the host's MemoryBlock.
+
+    State that isn't a parameter (e.g. the morph snapshots) goes into chunks
+    after the entries. Readers skip chunks they don't know, and older
+    versions never look past the entries, so chunks don't need a new version.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <cstring>
+
+class BinaryStateFormat
+{
+public:
+    static constexpr juce::uint32 magic = 0x54534646;   // "FFST" when read as little-endian bytes
+    static constexpr juce::uint16 currentVersion = 3;   // 2: slope choices 6-48 dB/oct, 3: slope moved to filterSlope
+    static constexpr int maxParameters = 64;
+
+    static constexpr size_t headerSize = 8, entrySize = 8;
+    static constexpr size_t maxSize = headerSize + maxParameters * entrySize;
+
+    /** Maps a value saved by an older format version to the current one. */
+    using Upgrader = float (*) (float savedValue, int savedVersion);
+
+    //==============================================================================
+    /** Adds a parameter to the state. Call for every parameter, from the processor's constructor. */
+    void addParameter (juce::RangedAudioParameter& parameter)
+    {
+        jassert (numParameters < maxParameters);
+
+        const auto hash = hashParameterID (parameter.getParameterID());
+
+        // Two IDs with the same hash would load into each other
+        for (int i = 0; i < numParameters; ++i)
+            jassert (entries[(size_t) i].idHash != hash);
+
+        entries[(size_t) numParameters++] = { hash, &parameter, nullptr, 0 };
+    }
+
+    /** Sets the function that converts the parameter's values from older versions. */
+    void setUpgrader (const juce::RangedAudioParameter& parameter, Upgrader upgrader)
+    {
+        for (int i = 0; i < numParameters; ++i)
+            if (entries[(size_t) i].parameter == &parameter)
+                entries[(size_t) i].upgrader = upgrader;
+    }
+
+    /** Older versions saved this parameter under legacyID. Data without an entry for
+        the parameter's own ID loads it from the legacy entry instead (through the
+        upgrader, like any value from an older version).
+    */
+    void setLegacyID (const juce::RangedAudioParameter& parameter, const juce::String& legacyID)
+    {
+        for (int i = 0; i < numParameters; ++i)
+            if (entries[(size_t) i].parameter == &parameter)
+                entries[(size_t) i].legacyHash = hashParameterID (legacyID);
+    }
+
+    /** Writes the current value of every parameter into destData, replacing its contents. */
+    void write (juce::MemoryBlock& destData) const
+    {
+        std::array<char, maxSize> buffer;
+        auto* out = buffer.data();
+
+        out = writeUint32 (out, magic);
+        out = writeUint16 (out, currentVersion);
+        out = writeUint16 (out, (juce::uint16) numParameters);
+
+        for (int i = 0; i < numParameters; ++i)
+        {
+            const auto& entry = entries[(size_t) i];
+            out = writeUint32 (out, entry.idHash);
+            out = writeFloat (out, entry.parameter->convertFrom0to1 (entry.parameter->getValue()));
+        }
+
+        destData.replaceAll (buffer.data(), (size_t) (out - buffer.data()));
+    }
+
+    //==============================================================================
+    /** True if the data starts with this format's header (anything else is an older XML state). */
+    static bool isBinaryState (const void* data, int sizeInBytes) noexcept
+    {
+        return data != nullptr && sizeInBytes >= (int) headerSize
+            && readUint32 (static_cast<const char*> (data)) == magic;
+    }
+
+    /** Restores the parameters from data written by write().
+        Returns false, leaving everything untouched, if the data is malformed or
+        comes from a newer format version.
+    */
+    bool read (const void* data, int sizeInBytes) const
+    {
+        if (! isBinaryState (data, sizeInBytes))
+            return false;
+
+        const auto* in = static_cast<const char*> (data);
+        const auto version = readUint16 (in + 4);
+        const auto numEntries = (int) readUint16 (in + 6);
+
+        if (version > currentVersion || (size_t) sizeInBytes < headerSize + (size_t) numEntries * entrySize)
+            return false;
+
+        std::array<bool, maxParameters> restored {};
+
+        for (int e = 0; e < numEntries; ++e)
+        {
+            const auto* entryData = in + headerSize + (size_t) e * entrySize;
+            const auto hash = readUint32 (entryData);
+            const auto savedValue = readFloat (entryData + 4);
+
+            // One entry can be a parameter's own ID and another's legacy ID; an own-ID
+            // entry always wins over a legacy one, whichever comes first
+            for (int i = 0; i < numParameters; ++i)
+            {
+                const auto& entry = entries[(size_t) i];
+                const bool legacyMatch = entry.legacyHash != 0 && entry.legacyHash == hash && ! restored[(size_t) i];
+
+                if (entry.idHash != hash && ! legacyMatch)
+                    continue;
+
+                auto value = savedValue;
+
+                if (version < currentVersion && entry.upgrader != nullptr)
+                    value = entry.upgrader (value, version);
+
+                entry.parameter->setValueNotifyingHost (entry.parameter->convertTo0to1 (value));
+                restored[(size_t) i] = true;
+            }
+        }
+
+        // Parameters added after the state was saved start from their defaults
+        for (int i = 0; i < numParameters; ++i)
+            if (! restored[(size_t) i])
+                entries[(size_t) i].parameter->setValueNotifyingHost (entries[(size_t) i].parameter->getDefaultValue());
+
+        return true;
+    }
+
+    //==============================================================================
+    /** Appends a chunk to state written by write(). */
+    static void appendChunk (juce::MemoryBlock& state, juce::uint32 chunkID, const void* data, size_t size)
+    {
+        std::array<char, 8> header;
+        writeUint32 (writeUint32 (header.data(), chunkID), (juce::uint32) size);
+
+        state.append (header.data(), header.size());
+        state.append (data, size);
+    }
+
+    /** The contents of the first chunk with the given ID, or an empty block if the
+        state doesn't have one (or is malformed).
+    */
+    static juce::MemoryBlock findChunk (const void* data, int sizeInBytes, juce::uint32 chunkID)
+    {
+        if (! isBinaryState (data, sizeInBytes))
+            return {};
+
+        const auto* in = static_cast<const char*> (data);
+        const auto end = (size_t) sizeInBytes;
+        auto position = headerSize + (size_t) readUint16 (in + 6) * entrySize;
+
+        while (position + 8 <= end)
+        {
+            const auto id = readUint32 (in + position);
+            const auto size = (size_t) readUint32 (in + position + 4);
+            position += 8;
+
+            if (size > end - position)
+                break;
+
+            if (id == chunkID)
+                return juce::MemoryBlock (in + position, size);
+
+            position += size;
+        }
+
+        return {};
+    }
+
+    //==============================================================================
+    /** 32-bit FNV-1a of the ID's UTF-8 bytes: stable across platforms and JUCE versions. */
+    static juce::uint32 hashParameterID (const juce::String& parameterID) noexcept
+    {
+        juce::uint32 hash = 2166136261u;
+
+        for (auto* c = parameterID.toRawUTF8(); *c != 0; ++c)
+        {
+            hash ^= (juce::uint8) *c;
+            hash *= 16777619u;
+        }
+
+        return hash;
+    }
+
+private:
+    //==============================================================================
+    static char* writeUint32 (char* out, juce::uint32 value) noexcept
+    {
+        value = juce::ByteOrder::swapIfBigEndian (value);
+        std::memcpy (out, &value, sizeof (value));
+        return out + sizeof (value);
+    }
+
+    static char* writeUint16 (char* out, juce::uint16 value) noexcept
+    {
+        value = juce::ByteOrder::swapIfBigEndian (value);
+        std::memcpy (out, &value, sizeof (value));
+        return out + sizeof (value);
+    }
+
+    static char* writeFloat (char* out, float value) noexcept
+    {
+        juce::uint32 bits;
+        std::memcpy (&bits, &value, sizeof (bits));
+        return writeUint32 (out, bits);
+    }
+
+    static juce::uint32 readUint32 (const char* in) noexcept     { return juce::ByteOrder::littleEndianInt (in); }
+    static juce::uint16 readUint16 (const char* in) noexcept     { return juce::ByteOrder::littleEndianShort (in); }
+
+    static float readFloat (const char* in) noexcept
+    {
+        const auto bits = readUint32 (in);
+        float value;
+        std::memcpy (&value, &bits, sizeof (value));
+        return value;
+    }
+
+    struct Entry
+    {
+        juce::uint32 idHash = 0;
+        juce::RangedAudioParameter* parameter = nullptr;
+        Upgrader upgrader = nullptr;
+        juce::uint32 legacyHash = 0;     // 0: none
+    };
+
+    std::array<Entry, maxParameters> entries;
+    int numParameters = 0;
+};
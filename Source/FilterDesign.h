@@ -0,0 +1,239 @@
+/*
+  ==============================================================================
+
+    Section layouts of the filter cascade for every slope.
+
+    A filter of order N (6 N dB/oct) runs as exactly the sections it needs:
+    N / 2 state variable sections, plus a one-pole section first when N is
+    odd. Each section's Q comes from a table worked out ahead of time, so the
+    cascade is a true Butterworth (maximally flat) or Linkwitz-Riley (two
+    Butterworths in series, -6 dB at the cutoff, for crossovers) filter, and
+    a steeper slope costs what its extra sections cost, nothing more.
+
+    The resonance control scales the Q of the last, highest-Q section, so at
+    its default the response is exactly the table's. Bandpass runs N state
+    variable sections at the resonance's Q; all but the last are normalised
+    to 0 dB at the centre, so steeper skirts don't also stack up gain.
+
+    Every layout also has its own FilterKernels::Cascade for each filter type,
+    compiled with its sections unrolled; getCascadeKernel() looks them up.
+
+    Like FilterKernels.h this header doesn't include JUCE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include "FilterKernels.h"
+
+namespace FilterDesign
+{
+    constexpr int numSlopes = 6;         // 6, 12, 18, 24, 36 and 48 dB/oct
+    constexpr int maxSections = 8;       // 48 dB/oct bandpass
+    constexpr int numLayouts = 3 * numSlopes;   // Butterworth, Linkwitz-Riley and bandpass tables
+
+    /** The slope parameter's choices, in order. */
+    inline constexpr std::array<int, numSlopes> slopeDecibelsPerOctave { 6, 12, 18, 24, 36, 48 };
+
+    /** The alignment parameter's choices, in order. */
+    enum Alignment
+    {
+        butterworth = 0,
+        linkwitzRiley
+    };
+
+    /** The resonance control's default: sections run at exactly their table Q there. */
+    constexpr double neutralResonance = 0.707;
+
+    //==============================================================================
+    struct CascadeLayout
+    {
+        int id = 0;                     // Position in the tables below, see getLayoutById()
+        int numSections = 0;
+        int firstResonantSection = 0;   // Sections from here on scale their Q by resonance / neutralResonance
+        std::array<int, maxSections> kinds {};      // FilterKernels::SectionKind
+        std::array<double, maxSections> q {};       // Unused by one-pole sections
+
+        /** Q of a section with the resonance control at the given value. */
+        constexpr double getSectionQ (int section, double resonance) const noexcept
+        {
+            return section >= firstResonantSection ? q[(std::size_t) section] * resonance / neutralResonance
+                                                   : q[(std::size_t) section];
+        }
+    };
+
+    /** Number of leading sections two layouts have in common at any resonance,
+        i.e. sections that can be computed once for both.
+    */
+    constexpr int getSharedSections (const CascadeLayout& a, const CascadeLayout& b) noexcept
+    {
+        int shared = 0;
+
+        while (shared < a.numSections && shared < b.numSections
+               && a.kinds[(std::size_t) shared] == b.kinds[(std::size_t) shared]
+               && a.q[(std::size_t) shared] == b.q[(std::size_t) shared]
+               && (shared >= a.firstResonantSection) == (shared >= b.firstResonantSection))
+            ++shared;
+
+        return shared;
+    }
+
+    //==============================================================================
+    // Butterworth pole pairs of order N sit at Q = 1 / (2 sin ((2k + 1) pi / 2N)) for
+    // even N and 1 / (2 cos (k pi / N)) for odd N (plus the real pole); lowest Q first,
+    // so the resonant peak comes last and the earlier sections have headroom.
+    inline constexpr std::array<CascadeLayout, numSlopes> butterworthLayouts
+    {{
+        { 0, 1, 1, { FilterKernels::onePoleSection }, {} },
+        { 1, 1, 0, {}, { 0.7071067812 } },
+        { 2, 2, 1, { FilterKernels::onePoleSection }, { 0.0, 1.0 } },
+        { 3, 2, 1, {}, { 0.5411961001, 1.3065629649 } },
+        { 4, 3, 2, {}, { 0.5176380902, 0.7071067812, 1.9318516526 } },
+        { 5, 4, 3, {}, { 0.5097955791, 0.6013448869, 0.8999762231, 2.5629154477 } }
+    }};
+
+    // Linkwitz-Riley of order 2N is Butterworth N twice over: the two real poles of an
+    // odd N make one section at Q = 0.5. Odd orders have no Linkwitz-Riley form and
+    // stay Butterworth (keeping the Butterworth id).
+    inline constexpr std::array<CascadeLayout, numSlopes> linkwitzRileyLayouts
+    {{
+        butterworthLayouts[0],
+        { 7, 1, 0, {}, { 0.5 } },
+        butterworthLayouts[2],
+        { 9, 2, 1, {}, { 0.7071067812, 0.7071067812 } },
+        { 10, 3, 2, {}, { 0.5, 1.0, 1.0 } },
+        { 11, 4, 3, {}, { 0.5411961001, 0.5411961001, 1.3065629649, 1.3065629649 } }
+    }};
+
+    constexpr CascadeLayout makeBandpassLayout (int id, int order) noexcept
+    {
+        CascadeLayout layout;
+        layout.id = id;
+        layout.numSections = order;
+        layout.firstResonantSection = 0;
+
+        for (int section = 0; section < order; ++section)
+        {
+            layout.kinds[(std::size_t) section] = section < order - 1 ? FilterKernels::unityPeakSection
+                                                                 : FilterKernels::twoPoleSection;
+            layout.q[(std::size_t) section] = neutralResonance;
+        }
+
+        return layout;
+    }
+
+    inline constexpr std::array<CascadeLayout, numSlopes> bandpassLayouts
+    {{
+        makeBandpassLayout (12, 1), makeBandpassLayout (13, 2), makeBandpassLayout (14, 3),
+        makeBandpassLayout (15, 4), makeBandpassLayout (16, 6), makeBandpassLayout (17, 8)
+    }};
+
+    //==============================================================================
+    /** Layout for a slope and alignment choice; bandpass ignores the alignment. */
+    constexpr const CascadeLayout& getLayout (int slopeIndex, int alignment, bool bandpass) noexcept
+    {
+        const auto index = (std::size_t) (slopeIndex >= 0 && slopeIndex < numSlopes ? slopeIndex : 0);
+
+        if (bandpass)
+            return bandpassLayouts[index];
+
+        return alignment == linkwitzRiley ? linkwitzRileyLayouts[index] : butterworthLayouts[index];
+    }
+
+    /** Layout with the given id: Butterworth, then Linkwitz-Riley, then bandpass, by slope. */
+    constexpr const CascadeLayout& getLayoutById (int id) noexcept
+    {
+        const auto index = (std::size_t) (id >= 0 && id < numLayouts ? id : 0);
+        const auto& table = index < numSlopes ? butterworthLayouts
+                          : (index < 2 * numSlopes ? linkwitzRileyLayouts : bandpassLayouts);
+
+        return table[index % numSlopes];
+    }
+
+    //==============================================================================
+    namespace detail
+    {
+        template <typename Register, typename SampleType, int layoutId, int filterType, std::size_t... sections>
+        constexpr FilterKernels::CascadeKernel<SampleType> makeCascadeKernel (std::index_sequence<sections...>) noexcept
+        {
+            return &FilterKernels::Cascade<Register, SampleType,
+                                           FilterKernels::getStageType (getLayoutById (layoutId).kinds[sections], filterType)...>::process;
+        }
+
+        template <typename Register, typename SampleType, int layoutId, int filterType>
+        constexpr FilterKernels::CascadeKernel<SampleType> makeCascadeKernel() noexcept
+        {
+            return makeCascadeKernel<Register, SampleType, layoutId, filterType>
+                       (std::make_index_sequence<(std::size_t) getLayoutById (layoutId).numSections>());
+        }
+
+        template <typename Register, typename SampleType, std::size_t... layoutIds>
+        constexpr auto makeCascadeKernelTable (std::index_sequence<layoutIds...>) noexcept
+        {
+            using Kernels = std::array<FilterKernels::CascadeKernel<SampleType>, 3>;
+
+            return std::array<Kernels, sizeof... (layoutIds)>
+            {{
+                Kernels { makeCascadeKernel<Register, SampleType, (int) layoutIds, FilterKernels::lowpass>(),
+                          makeCascadeKernel<Register, SampleType, (int) layoutIds, FilterKernels::bandpass>(),
+                          makeCascadeKernel<Register, SampleType, (int) layoutIds, FilterKernels::highpass>() }...
+            }};
+        }
+    }
+
+    /** The compiled cascade for a layout and filter type (lowpass, bandpass or highpass).
+        Looking it up is a table read, so it's cheap enough to do once per block.
+    */
+    template <typename Register, typename SampleType>
+    FilterKernels::CascadeKernel<SampleType> getCascadeKernel (int layoutId, int filterType) noexcept
+    {
+        static constexpr auto kernels = detail::makeCascadeKernelTable<Register, SampleType>
+                                            (std::make_index_sequence<(std::size_t) numLayouts>());
+
+        return kernels[(std::size_t) (layoutId >= 0 && layoutId < numLayouts ? layoutId : 0)]
+                      [(std::size_t) (filterType >= 0 && filterType < 3 ? filterType : 0)];
+    }
+
+    //==============================================================================
+    /** Time the cascade takes to ring down by the given number of decibels once its
+        input stops: each section's ring-down, set by its slowest pole, in turn.
+    */
+    inline double getDecayTimeSeconds (const CascadeLayout& layout, double cutoff, double resonance,
+                                       double decibels) noexcept
+    {
+        constexpr double pi = 3.141592653589793;
+        const auto nepers = decibels * std::log (10.0) / 20.0;
+        const auto omega = 2.0 * pi * std::max (cutoff, 1.0);
+        double seconds = 0.0;
+
+        for (int section = 0; section < layout.numSections; ++section)
+        {
+            // A real pole decays at the cutoff itself
+            auto rate = omega;
+
+            if (layout.kinds[(std::size_t) section] != FilterKernels::onePoleSection)
+            {
+                // Poles at omega / 2Q (1 +- sqrt (1 - 4 Q^2)): underdamped ones decay at
+                // omega / 2Q, overdamped ones are held up by the slower real pole
+                const auto q = std::max (layout.getSectionQ (section, resonance), 0.01);
+                rate = omega / (2.0 * q) * (1.0 - std::sqrt (std::max (0.0, 1.0 - 4.0 * q * q)));
+            }
+
+            seconds += nepers / rate;
+        }
+
+        return seconds;
+    }
+
+    /** Sessions and presets saved before format version 2 only had 6, 12 and 24 dB/oct. */
+    constexpr int getSlopeIndexFromVersion1 (int legacySlopeIndex) noexcept
+    {
+        return legacySlopeIndex >= 2 ? 3 : (legacySlopeIndex < 0 ? 0 : legacySlopeIndex);
+    }
+}
@@ -0,0 +1,228 @@
+/*
+  ==============================================================================
+
+    Vectorised state variable filter kernels.
+
+    The kernels work on channel-interleaved frames: each frame holds one sample
+    for every lane of a SIMD register, so all lanes are filtered with a single
+    register operation. Coefficients are per lane too, so lanes can run the
+    same sections at different cutoffs and resonances.
+
+    This header deliberately doesn't include JUCE, so it can be compiled into
+    translation units built with different instruction set flags without
+    breaking the one-definition rule.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+namespace FilterKernels
+{
+    /** Output taps, in the same order as juce::dsp::StateVariableTPTFilterType,
+        followed by the taps only some kinds of section have.
+    */
+    enum StageType
+    {
+        lowpass = 0,
+        bandpass,
+        highpass,
+        unityPeakBandpass,  // Bandpass scaled by R2, so 0 dB at the centre whatever the Q
+        onePoleLowpass,
+        onePoleHighpass
+    };
+
+    /** What a section of a cascade computes. */
+    enum SectionKind
+    {
+        twoPoleSection = 0,         // State variable section
+        onePoleSection,             // Real pole, for odd filter orders (lowpass and highpass only)
+        unityPeakSection            // State variable section whose bandpass tap peaks at 0 dB
+    };
+
+    /** Tap to run a section of the given kind with, for a filter of the given type (lowpass, bandpass or highpass). */
+    constexpr int getStageType (int sectionKind, int filterType) noexcept
+    {
+        if (sectionKind == onePoleSection)
+            return filterType == highpass ? onePoleHighpass : onePoleLowpass;
+
+        if (sectionKind == unityPeakSection && filterType == bandpass)
+            return unityPeakBandpass;
+
+        return filterType;
+    }
+
+    /** A section's coefficients and state, loaded into registers.
+
+        coefficients holds { g[width], R2[width], h[width] }, one value per lane.
+        One-pole sections keep G (g / (1 + g)) in h and only use s1 as state.
+
+        Register must provide size(), fromRawArray(), copyToRawArray() and the
+        arithmetic operators, as juce::dsp::SIMDRegister does. The state and
+        coefficients must be aligned for Register loads and stores.
+    */
+    template <typename Register>
+    struct StageRegisters
+    {
+        template <typename SampleType>
+        StageRegisters (const SampleType* s1, const SampleType* s2, const SampleType* coefficients) noexcept
+            : ls1 (Register::fromRawArray (s1)), ls2 (Register::fromRawArray (s2)),
+              vg (Register::fromRawArray (coefficients)),
+              vh (Register::fromRawArray (coefficients + 2 * Register::size())),
+              vR2 (Register::fromRawArray (coefficients + Register::size())),
+              vgR (vg + vR2)
+        {
+        }
+
+        template <typename SampleType>
+        void store (SampleType* s1, SampleType* s2) const noexcept
+        {
+            ls1.copyToRawArray (s1);
+            ls2.copyToRawArray (s2);
+        }
+
+        /** Filters one frame through the section, returning the type's tap. Only
+            the maths that tap needs is compiled in.
+        */
+        template <int type>
+        Register tick (Register x) noexcept
+        {
+            if constexpr (type == onePoleLowpass || type == onePoleHighpass)
+            {
+                const auto v   = (x - ls1) * vh;
+                const auto yLP = v + ls1;
+                ls1            = yLP + v;
+
+                if constexpr (type == onePoleLowpass)   return yLP;
+                else                                    return x - yLP;
+            }
+            else
+            {
+                const auto yHP = vh * (x - ls1 * vgR - ls2);
+
+                const auto yBP = yHP * vg + ls1;
+                ls1            = yHP * vg + yBP;
+
+                const auto yLP = yBP * vg + ls2;
+                ls2            = yBP * vg + yLP;
+
+                if constexpr (type == lowpass)                  return yLP;
+                else if constexpr (type == bandpass)            return yBP;
+                else if constexpr (type == unityPeakBandpass)   return yBP * vR2;
+                else                                            return yHP;
+            }
+        }
+
+        Register ls1, ls2;
+        const Register vg, vh, vR2, vgR;
+    };
+
+    /** Runs one section over numFrames interleaved frames in place. frames must be
+        aligned for Register loads and stores.
+    */
+    template <typename Register, typename SampleType, int type>
+    void processStage (SampleType* frames, int numFrames, SampleType* s1, SampleType* s2,
+                       const SampleType* coefficients) noexcept
+    {
+        constexpr int width = static_cast<int> (Register::size());
+
+        StageRegisters<Register> stage (s1, s2, coefficients);
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            auto* frame = frames + i * width;
+            stage.template tick<type> (Register::fromRawArray (frame)).copyToRawArray (frame);
+        }
+
+        stage.store (s1, s2);
+    }
+
+    /** Runs processStage() with the output tap chosen at runtime. */
+    template <typename Register, typename SampleType>
+    void processStage (SampleType* frames, int numFrames, SampleType* s1, SampleType* s2,
+                       const SampleType* coefficients, int type) noexcept
+    {
+        switch (type)
+        {
+            case bandpass:          processStage<Register, SampleType, bandpass> (frames, numFrames, s1, s2, coefficients); break;
+            case highpass:          processStage<Register, SampleType, highpass> (frames, numFrames, s1, s2, coefficients); break;
+            case unityPeakBandpass: processStage<Register, SampleType, unityPeakBandpass> (frames, numFrames, s1, s2, coefficients); break;
+            case onePoleLowpass:    processStage<Register, SampleType, onePoleLowpass> (frames, numFrames, s1, s2, coefficients); break;
+            case onePoleHighpass:   processStage<Register, SampleType, onePoleHighpass> (frames, numFrames, s1, s2, coefficients); break;
+            default:                processStage<Register, SampleType, lowpass>  (frames, numFrames, s1, s2, coefficients); break;
+        }
+    }
+
+    //==============================================================================
+    /** Runs a whole cascade over numFrames interleaved frames in place, as returned
+        by FilterDesign::getCascadeKernel().
+
+        state holds each section's { s1[width], s2[width] } in turn and coefficients
+        each section's { g[width], R2[width], h[width] }.
+    */
+    template <typename SampleType>
+    using CascadeKernel = void (*) (SampleType* frames, int numFrames, SampleType* state,
+                                    const SampleType* coefficients) noexcept;
+
+    /** A cascade whose sections and taps are fixed at compile time, one tap per section.
+
+        Every frame goes through all the sections while it's in a register, with
+        the section loop unrolled and each section's state and coefficients kept
+        in registers, so the frames are loaded and stored once per block rather
+        than once per section, and nothing is decided per section at runtime.
+    */
+    template <typename Register, typename SampleType, int... stageTypes>
+    struct Cascade
+    {
+        static constexpr int numStages = static_cast<int> (sizeof... (stageTypes));
+
+        static void process (SampleType* frames, int numFrames, SampleType* state,
+                             const SampleType* coefficients) noexcept
+        {
+            process (frames, numFrames, state, coefficients, std::make_index_sequence<sizeof... (stageTypes)>());
+        }
+
+    private:
+        template <std::size_t... stages>
+        static void process (SampleType* frames, int numFrames, SampleType* state,
+                             const SampleType* coefficients, std::index_sequence<stages...>) noexcept
+        {
+            constexpr int width = static_cast<int> (Register::size());
+
+            StageRegisters<Register> sections[]
+            {
+                StageRegisters<Register> (state + stages * 2 * width, state + (stages * 2 + 1) * width,
+                                          coefficients + stages * 3 * width)...
+            };
+
+            for (int i = 0; i < numFrames; ++i)
+            {
+                auto* frame = frames + i * width;
+                auto x = Register::fromRawArray (frame);
+
+                ((x = sections[stages].template tick<stageTypes> (x)), ...);
+
+                x.copyToRawArray (frame);
+            }
+
+            (sections[stages].store (state + stages * 2 * width, state + (stages * 2 + 1) * width), ...);
+        }
+    };
+
+   #if FRANKYS_FILTERS_AVX2_KERNEL
+    /** 8-lane float kernel built with AVX2/FMA enabled (see FilterKernelsAVX2.cpp).
+        Only call this after checking juce::SystemStats::hasAVX2().
+    */
+    void processStageAVX2 (float* frames, int numFrames, float* s1, float* s2,
+                           const float* coefficients, int type) noexcept;
+
+    /** 8-lane float build of FilterDesign::getCascadeKernel(), with the same AVX2 caveat. */
+    CascadeKernel<float> getCascadeKernelAVX2 (int layoutId, int filterType) noexcept;
+
+    /** Number of lanes processed by processStageAVX2() and getCascadeKernelAVX2()'s kernels. */
+    constexpr int avx2Width = 8;
+   #endif
+}
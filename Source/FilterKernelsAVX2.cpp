@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    AVX2 build of the state variable filter kernels.
+
+    This file is compiled with -mavx2 -mfma on Linux x86-64 and must not
+    include any JUCE headers, otherwise AVX2 code could end up in inline
+    functions shared with the rest of the plugin. The processor only calls
+    into it after juce::SystemStats::hasAVX2() has confirmed CPU support.
+
+  ==============================================================================
+*/
+
+#include "FilterKernels.h"
+#include "FilterDesign.h"
+
+#if FRANKYS_FILTERS_AVX2_KERNEL
+
+#include <immintrin.h>
+#include <cstddef>
+
+namespace
+{
+    struct AVXFloatRegister
+    {
+        __m256 value;
+
+        static constexpr std::size_t size() noexcept                    { return 8; }
+        static AVXFloatRegister fromRawArray (const float* a) noexcept  { return { _mm256_load_ps (a) }; }
+        void copyToRawArray (float* a) const noexcept                   { _mm256_store_ps (a, value); }
+
+        AVXFloatRegister operator+ (AVXFloatRegister other) const noexcept  { return { _mm256_add_ps (value, other.value) }; }
+        AVXFloatRegister operator- (AVXFloatRegister other) const noexcept  { return { _mm256_sub_ps (value, other.value) }; }
+        AVXFloatRegister operator* (AVXFloatRegister other) const noexcept  { return { _mm256_mul_ps (value, other.value) }; }
+    };
+}
+
+void FilterKernels::processStageAVX2 (float* frames, int numFrames, float* s1, float* s2,
+                                      const float* coefficients, int type) noexcept
+{
+    processStage<AVXFloatRegister, float> (frames, numFrames, s1, s2, coefficients, type);
+}
+
+FilterKernels::CascadeKernel<float> FilterKernels::getCascadeKernelAVX2 (int layoutId, int filterType) noexcept
+{
+    return FilterDesign::getCascadeKernel<AVXFloatRegister, float> (layoutId, filterType);
+}
+
+#endif
@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    Oversampling around the filter chain.
+
+    Holds a juce::dsp::Oversampling instance for every factor (2x, 4x, 8x) and
+    both filter designs, all allocated up front, so switching between them on
+    the audio thread never allocates. Only the selected one does any work;
+    at 1x nothing runs at all.
+
+    Also provides the delay used to pad a lower factor's latency up to a fixed
+    reported latency, so the host doesn't see the latency change every time
+    the automatic mode switches factor. There are two delay lines, so while a
+    factor switch crossfades, the outgoing path keeps its own padding.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <memory>
+
+/** The filter designs, outside the template so float and double oversamplers share them. */
+struct FilterOversamplingDesigns
+{
+    enum FilterDesign
+    {
+        polyphaseIIR = 0,
+        linearPhaseFIR
+    };
+};
+
+template <typename SampleType>
+class FilterOversampling  : public FilterOversamplingDesigns
+{
+public:
+    /** Factor index: 0 = 1x, 1 = 2x, 2 = 4x, 3 = 8x. */
+    static constexpr int maxFactorIndex = 3;
+    static constexpr int maxFactor = 1 << maxFactorIndex;
+    static constexpr int numDelayLines = 2;
+
+    //==============================================================================
+    /** Allocates every oversampler and the padding delays. Must not be called on the audio thread. */
+    void prepare (int numChannels, int maxBlockSize)
+    {
+        using Oversampling = juce::dsp::Oversampling<SampleType>;
+        int maxLatency = 0;
+
+        for (int design = 0; design < 2; ++design)
+        {
+            for (int index = 1; index <= maxFactorIndex; ++index)
+            {
+                auto& oversampler = oversamplers[(size_t) design][(size_t) index - 1];
+                oversampler = std::make_unique<Oversampling> ((size_t) numChannels, (size_t) index,
+                                                              design == polyphaseIIR ? Oversampling::filterHalfBandPolyphaseIIR
+                                                                                     : Oversampling::filterHalfBandFIREquiripple,
+                                                              true, true);
+                oversampler->initProcessing ((size_t) maxBlockSize);
+                maxLatency = juce::jmax (maxLatency, getLatencySamples (index, (FilterDesign) design));
+            }
+        }
+
+        for (auto& line : delayLines)
+            line.buffer.setSize (numChannels, juce::jmax (1, maxLatency));
+
+        reset();
+    }
+
+    /** Clears every oversampler and the padding delays. */
+    void reset() noexcept
+    {
+        for (auto& design : oversamplers)
+            for (auto& oversampler : design)
+                if (oversampler != nullptr)
+                    oversampler->reset();
+
+        for (int line = 0; line < numDelayLines; ++line)
+            resetDelay (line);
+    }
+
+    void resetFactor (int factorIndex, FilterDesign design) noexcept
+    {
+        if (factorIndex > 0)
+            get (factorIndex, design).reset();
+    }
+
+    void resetDelay (int line) noexcept
+    {
+        delayLines[(size_t) line].buffer.clear();
+        delayLines[(size_t) line].position = 0;
+    }
+
+    //==============================================================================
+    /** Latency added by the given factor and design, in samples at the base rate. */
+    int getLatencySamples (int factorIndex, FilterDesign design) const noexcept
+    {
+        if (factorIndex <= 0)
+            return 0;
+
+        return (int) std::ceil (oversamplers[(size_t) design][(size_t) factorIndex - 1]->getLatencyInSamples());
+    }
+
+    /** Upsamples the block and returns the oversampled block to process in place. */
+    juce::dsp::AudioBlock<SampleType> processUp (const juce::dsp::AudioBlock<SampleType>& block,
+                                                 int factorIndex, FilterDesign design) noexcept
+    {
+        return get (factorIndex, design).processSamplesUp (block);
+    }
+
+    /** Downsamples the block returned by processUp() back into block. */
+    void processDown (juce::dsp::AudioBlock<SampleType> block, int factorIndex, FilterDesign design) noexcept
+    {
+        get (factorIndex, design).processSamplesDown (block);
+    }
+
+    /** Delays the block by delaySamples (at most the largest oversampler latency) on one delay line. */
+    void processDelay (const juce::dsp::AudioBlock<SampleType>& block, int delaySamples, int line) noexcept
+    {
+        if (delaySamples <= 0)
+            return;
+
+        auto& delayBuffer = delayLines[(size_t) line].buffer;
+        auto& delayPosition = delayLines[(size_t) line].position;
+
+        jassert (delaySamples <= delayBuffer.getNumSamples());
+        const auto channels = juce::jmin ((int) block.getNumChannels(), delayBuffer.getNumChannels());
+        auto position = delayPosition;
+
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            auto* samples = block.getChannelPointer ((size_t) ch);
+            auto* delayed = delayBuffer.getWritePointer (ch);
+            position = delayPosition;
+
+            for (size_t i = 0; i < block.getNumSamples(); ++i)
+            {
+                std::swap (samples[i], delayed[position]);
+
+                if (++position >= delaySamples)
+                    position = 0;
+            }
+        }
+
+        delayPosition = position;
+    }
+
+private:
+    juce::dsp::Oversampling<SampleType>& get (int factorIndex, FilterDesign design) const noexcept
+    {
+        jassert (factorIndex >= 1 && factorIndex <= maxFactorIndex);
+        return *oversamplers[(size_t) design][(size_t) factorIndex - 1];
+    }
+
+    std::array<std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, (size_t) maxFactorIndex>, 2> oversamplers;
+
+    struct DelayLine
+    {
+        juce::AudioBuffer<SampleType> buffer;
+        int position = 0;
+    };
+
+    std::array<DelayLine, (size_t) numDelayLines> delayLines;
+};
@@ -0,0 +1,275 @@
+/*
+  ==============================================================================
+
+    Morphing between parameter snapshots (e.g. presets).
+
+    Up to four snapshots sit at the corners of a unit square: A and B along
+    the bottom (the plain A/B morph knob), C and D above them (XY pad). Every
+    morph position's values are computed ahead of time into a table when a
+    snapshot changes, so moving the morph control is a table lookup on the
+    audio thread: no file reads, no parameter range maths, no allocation.
+
+    Continuous parameters blend in their normalised (knob) domain, so e.g.
+    cutoff sweeps the way its knob does. Stepped parameters (choices) take
+    the value of whichever snapshot the position is closest to.
+
+    Tables are handed to the audio thread through a triple buffer, all three
+    allocated up front, so rebuilding one never blocks or frees anything the
+    audio thread might be reading.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <vector>
+
+class MorphEngine
+{
+public:
+    static constexpr int maxTargets = 9;
+    static constexpr int numSlots = 4;      // A, B along X; C, D above them along Y
+    static constexpr int gridSize = 33;     // Table points per axis
+
+    struct Target
+    {
+        juce::String parameterID;
+        juce::NormalisableRange<float> range;
+        float defaultValue = 0.0f;          // Raw; used when a snapshot doesn't contain the parameter
+        bool stepped = false;               // Nearest snapshot's value instead of a blend
+    };
+
+    //==============================================================================
+    MorphEngine() : tables (3) {}
+
+    /** Adds a parameter the morph controls. Call before any snapshots are set. */
+    void addTarget (const Target& target)
+    {
+        jassert (numTargets < maxTargets);
+        targets[(size_t) numTargets++] = target;
+    }
+
+    int getNumTargets() const noexcept      { return numTargets; }
+
+    //==============================================================================
+    /** Message thread: stores a snapshot (raw values by parameter ID) in a slot and
+        rebuilds the table. The morph is active once A and B are set; a missing C or
+        D stands in for A or B respectively.
+    */
+    void setSnapshot (int slot, const juce::NamedValueSet& rawValues)
+    {
+        jassert (juce::isPositiveAndBelow (slot, numSlots));
+        const juce::ScopedLock sl (writerLock);
+
+        for (int t = 0; t < numTargets; ++t)
+        {
+            const auto& target = targets[(size_t) t];
+            const auto* value = rawValues.getVarPointer (target.parameterID);
+            const auto raw = value != nullptr ? static_cast<float> (*value) : target.defaultValue;
+
+            snapshots[(size_t) slot][(size_t) t] = target.range.convertTo0to1 (juce::jlimit (target.range.start, target.range.end, raw));
+        }
+
+        hasSnapshots[(size_t) slot] = true;
+        rebuild();
+    }
+
+    /** Message thread: empties every slot, which turns the morph off. */
+    void clearSnapshots()
+    {
+        const juce::ScopedLock sl (writerLock);
+        hasSnapshots.fill (false);
+        rebuild();
+    }
+
+    bool hasSnapshot (int slot) const
+    {
+        const juce::ScopedLock sl (writerLock);
+        return juce::isPositiveAndBelow (slot, numSlots) && hasSnapshots[(size_t) slot];
+    }
+
+    /** Message thread: a slot's raw values by parameter ID, as setSnapshot() would take
+        them back (e.g. to save them with the session). Empty if the slot is.
+    */
+    juce::NamedValueSet getSnapshot (int slot) const
+    {
+        const juce::ScopedLock sl (writerLock);
+        juce::NamedValueSet rawValues;
+
+        if (juce::isPositiveAndBelow (slot, numSlots) && hasSnapshots[(size_t) slot])
+            for (int t = 0; t < numTargets; ++t)
+                rawValues.set (targets[(size_t) t].parameterID,
+                               targets[(size_t) t].range.convertFrom0to1 (snapshots[(size_t) slot][(size_t) t]));
+
+        return rawValues;
+    }
+
+    //==============================================================================
+    /** Audio thread, once per block: picks up the latest table. Returns true if it changed. */
+    bool update() noexcept
+    {
+        if ((middle.load (std::memory_order_relaxed) & newTableFlag) == 0)
+            return false;
+
+        readIndex = middle.exchange (readIndex, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    /** Audio thread: true while the current table has at least snapshots A and B. */
+    bool isActive() const noexcept          { return tables[(size_t) readIndex].active; }
+
+    /** Audio thread: raw morphed value of every target at (x, y), in the order they were added. */
+    void getValues (float x, float y, float* dest) const noexcept
+    {
+        const auto& table = tables[(size_t) readIndex];
+        interpolate (x, y, table.stepped, table.numTargets,
+                     [&table] (int gx, int gy) { return table.getPoint (gx, gy); }, dest);
+    }
+
+    /** Any other thread: what getValues() gives once the audio thread has picked up
+        the latest snapshots, worked out from the snapshots themselves (e.g. for the
+        editor). Returns false, leaving dest alone, while the morph is off.
+    */
+    bool getLatestValues (float x, float y, float* dest) const
+    {
+        const juce::ScopedLock sl (writerLock);
+
+        if (! (hasSnapshots[0] && hasSnapshots[1]))
+            return false;
+
+        std::array<bool, maxTargets> stepped {};
+        for (int t = 0; t < numTargets; ++t)
+            stepped[(size_t) t] = targets[(size_t) t].stepped;
+
+        // Only the grid points around (x, y) are needed: four, plus the nearest again
+        std::array<std::array<float, maxTargets>, 5> points;
+        size_t numPoints = 0;
+
+        interpolate (x, y, stepped, numTargets, [this, &points, &numPoints] (int gx, int gy)
+        {
+            auto* point = points[numPoints++].data();
+            computePoint (gx, gy, point);
+            return static_cast<const float*> (point);
+        }, dest);
+
+        return true;
+    }
+
+private:
+    //==============================================================================
+    template <typename PointGetter>
+    static void interpolate (float x, float y, const std::array<bool, maxTargets>& stepped, int numTargets,
+                             PointGetter&& getPoint, float* dest) noexcept
+    {
+        const auto fx = juce::jlimit (0.0f, 1.0f, x) * (gridSize - 1);
+        const auto fy = juce::jlimit (0.0f, 1.0f, y) * (gridSize - 1);
+        const auto ix = juce::jmin ((int) fx, gridSize - 2);
+        const auto iy = juce::jmin ((int) fy, gridSize - 2);
+        const auto tx = fx - (float) ix;
+        const auto ty = fy - (float) iy;
+
+        const auto* p00 = getPoint (ix, iy);
+        const auto* p10 = getPoint (ix + 1, iy);
+        const auto* p01 = getPoint (ix, iy + 1);
+        const auto* p11 = getPoint (ix + 1, iy + 1);
+
+        const auto* nearest = getPoint (ix + (tx >= 0.5f ? 1 : 0), iy + (ty >= 0.5f ? 1 : 0));
+
+        for (int t = 0; t < numTargets; ++t)
+        {
+            if (stepped[(size_t) t])
+            {
+                dest[t] = nearest[t];
+                continue;
+            }
+
+            const auto bottom = p00[t] + (p10[t] - p00[t]) * tx;
+            const auto top = p01[t] + (p11[t] - p01[t]) * tx;
+            dest[t] = bottom + (top - bottom) * ty;
+        }
+    }
+
+    //==============================================================================
+    struct Table
+    {
+        bool active = false;
+        int numTargets = 0;
+        std::array<bool, maxTargets> stepped {};
+        std::array<float, gridSize * gridSize * maxTargets> points {};  // [y][x][target], raw values
+
+        const float* getPoint (int x, int y) const noexcept    { return points.data() + (y * gridSize + x) * maxTargets; }
+        float* getPoint (int x, int y) noexcept                { return points.data() + (y * gridSize + x) * maxTargets; }
+    };
+
+    void rebuild()
+    {
+        auto& table = tables[(size_t) writeIndex];
+        table.active = hasSnapshots[0] && hasSnapshots[1];
+        table.numTargets = numTargets;
+
+        if (table.active)
+        {
+            for (int t = 0; t < numTargets; ++t)
+                table.stepped[(size_t) t] = targets[(size_t) t].stepped;
+
+            for (int gy = 0; gy < gridSize; ++gy)
+                for (int gx = 0; gx < gridSize; ++gx)
+                    computePoint (gx, gy, table.getPoint (gx, gy));
+        }
+
+        // Publish: the filled table becomes the middle one, and the old middle is the next to write
+        writeIndex = middle.exchange (writeIndex | newTableFlag, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Raw values of every target at one grid point. Needs A and B set.
+    void computePoint (int gx, int gy, float* point) const
+    {
+        const auto& a = snapshots[0];
+        const auto& b = snapshots[1];
+        const auto& c = hasSnapshots[2] ? snapshots[2] : a;
+        const auto& d = hasSnapshots[3] ? snapshots[3] : b;
+
+        const auto x = (float) gx / (gridSize - 1);
+        const auto y = (float) gy / (gridSize - 1);
+        const std::array<float, numSlots> weights { (1.0f - x) * (1.0f - y), x * (1.0f - y),
+                                                    (1.0f - x) * y,          x * y };
+
+        // Stepped targets follow the corner with the biggest weight (the first on a tie)
+        const auto closest = (int) std::distance (weights.begin(), std::max_element (weights.begin(), weights.end()));
+        const std::array<const std::array<float, maxTargets>*, numSlots> corners { &a, &b, &c, &d };
+
+        for (int t = 0; t < numTargets; ++t)
+        {
+            const auto& target = targets[(size_t) t];
+
+            const auto normalised = target.stepped
+                                  ? (*corners[(size_t) closest])[(size_t) t]
+                                  : weights[0] * a[(size_t) t] + weights[1] * b[(size_t) t]
+                                      + weights[2] * c[(size_t) t] + weights[3] * d[(size_t) t];
+
+            point[t] = target.range.convertFrom0to1 (normalised);
+        }
+    }
+
+    //==============================================================================
+    std::array<Target, maxTargets> targets;
+    int numTargets = 0;
+
+    std::array<std::array<float, maxTargets>, numSlots> snapshots {};  // Normalised
+    std::array<bool, numSlots> hasSnapshots {};
+    juce::CriticalSection writerLock;
+
+    static constexpr int indexMask = 3, newTableFlag = 4;
+
+    std::vector<Table> tables;
+    int writeIndex = 0;                 // Message thread only
+    int readIndex = 1;                  // Audio thread only
+    std::atomic<int> middle { 2 };      // Index of the spare table, plus newTableFlag if it hasn't been read
+
+    JUCE_DECLARE_NON_COPYABLE (MorphEngine)
+};
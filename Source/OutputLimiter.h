@@ -0,0 +1,354 @@
+/*
+  ==============================================================================
+
+    Output limiter with a cheap bypass for blocks that don't need limiting.
+
+    Gain is computed per sample from the linked peak of all channels, with an
+    instant attack and exponential release, so no output sample exceeds the
+    threshold. With lookahead, the audio is delayed and the gain reduction is
+    ramped in over the lookahead window ahead of each peak instead of being
+    applied abruptly.
+
+    In true-peak mode the detector runs on a 4x oversampled copy of the input,
+    so inter-sample peaks are caught as well. The oversampler's latency is
+    added to the delay, and getLatencySamples() reports the total.
+
+    When a block's peak stays below the threshold and the gain is fully
+    released, the per-sample gain computation is skipped. The block is left
+    untouched, or only delayed if lookahead is active.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <cmath>
+#include <limits>
+#include <memory>
+
+template <typename SampleType>
+class OutputLimiter
+{
+public:
+    //==============================================================================
+    /** Allocates everything the limiter needs for up to maxLookaheadMs of lookahead. */
+    void prepare (const juce::dsp::ProcessSpec& spec, double maxLookaheadMs)
+    {
+        sampleRate = spec.sampleRate;
+        numChannels = (int) spec.numChannels;
+        maxBlockSize = (int) spec.maximumBlockSize;
+
+        using Oversampling = juce::dsp::Oversampling<SampleType>;
+        truePeakDetector = std::make_unique<Oversampling> ((size_t) numChannels, 2,
+                                                           Oversampling::filterHalfBandFIREquiripple,
+                                                           true, true);
+        truePeakDetector->initProcessing ((size_t) maxBlockSize);
+        truePeakLatency = (int) std::ceil (truePeakDetector->getLatencyInSamples());
+
+        // The true-peak window holds one extra sample to cover the detector's group delay
+        maxHoldSamples = juce::roundToInt (maxLookaheadMs * 0.001 * sampleRate) + 1;
+        const auto maxDelay = truePeakLatency + maxHoldSamples;
+
+        delayBuffer.setSize (numChannels, juce::jmax (1, maxDelay));
+        minimumQueue.allocate ((size_t) maxHoldSamples + 1, true);
+        averageBuffer.allocate ((size_t) maxHoldSamples + 1, true);
+
+        holdSamples = getHoldSamples (truePeak, lookaheadMs);
+        updateRelease();
+        reset();
+    }
+
+    /** Clears the delay line and releases any gain reduction. */
+    void reset() noexcept
+    {
+        delayBuffer.clear();
+
+        if (truePeakDetector != nullptr)
+            truePeakDetector->reset();
+
+        delayWritePosition = 0;
+        sampleCounter = 0;
+        queueHead = queueSize = 0;
+        averagePosition = 0;
+        averageSum = (double) (holdSamples + 1);
+
+        if (averageBuffer != nullptr)
+            std::fill (averageBuffer.get(), averageBuffer.get() + holdSamples + 1, SampleType (1));
+
+        envelope = SampleType (1);
+        samplesWithoutReduction = std::numeric_limits<int>::max();
+    }
+
+    //==============================================================================
+    void setThreshold (SampleType newThresholdDb) noexcept
+    {
+        threshold = juce::Decibels::decibelsToGain (newThresholdDb);
+    }
+
+    void setRelease (SampleType newReleaseMs) noexcept
+    {
+        releaseMs = newReleaseMs;
+        updateRelease();
+    }
+
+    /** Switches between sample-peak and true-peak detection and sets the lookahead.
+        This doesn't allocate, but clears the limiter if anything changed.
+        Returns true if the latency changed as a result.
+    */
+    bool setMode (bool shouldUseTruePeak, double newLookaheadMs) noexcept
+    {
+        const auto newHoldSamples = getHoldSamples (shouldUseTruePeak, newLookaheadMs);
+        lookaheadMs = newLookaheadMs;
+
+        if (shouldUseTruePeak == truePeak && newHoldSamples == holdSamples)
+            return false;
+
+        const auto oldLatency = getLatencySamples();
+
+        truePeak = shouldUseTruePeak;
+        holdSamples = newHoldSamples;
+        reset();
+
+        return getLatencySamples() != oldLatency;
+    }
+
+    /** Delay added to the signal by lookahead and true-peak detection. */
+    int getLatencySamples() const noexcept
+    {
+        return (truePeak ? truePeakLatency : 0) + holdSamples;
+    }
+
+    //==============================================================================
+    void process (const juce::dsp::ProcessContextReplacing<SampleType>& context) noexcept
+    {
+        const auto& block = context.getOutputBlock();
+        const auto numSamples = (int) block.getNumSamples();
+
+        reducedSamples = 0;
+        lowestGain = SampleType (1);
+
+        for (int start = 0; start < numSamples; start += maxBlockSize)
+            processChunk (block.getSubBlock ((size_t) start, (size_t) juce::jmin (maxBlockSize, numSamples - start)));
+    }
+
+    //==============================================================================
+    /** Number of samples in the last process() call that had their gain reduced. */
+    int getReducedSamples() const noexcept          { return reducedSamples; }
+
+    /** Deepest gain reduction applied during the last process() call, in dB (<= 0). */
+    SampleType getMaxGainReductionDb() const noexcept
+    {
+        return juce::Decibels::gainToDecibels (lowestGain);
+    }
+
+private:
+    //==============================================================================
+    void processChunk (const juce::dsp::AudioBlock<SampleType>& block) noexcept
+    {
+        const auto numSamples = (int) block.getNumSamples();
+        const auto channelsToProcess = juce::jmin ((int) block.getNumChannels(), numChannels);
+
+        juce::dsp::AudioBlock<SampleType> detectionBlock (block);
+        int oversampling = 1;
+
+        if (truePeak)
+        {
+            detectionBlock = truePeakDetector->processSamplesUp (block.getSubsetChannelBlock (0, (size_t) channelsToProcess));
+            oversampling = (int) truePeakDetector->getOversamplingFactor();
+        }
+
+        // Cheap bypass: nothing to limit in this block and no gain reduction pending
+        if (isReleased() && getPeak (detectionBlock, channelsToProcess) <= threshold)
+        {
+            if (getLatencySamples() > 0)
+                delaySamples (block, channelsToProcess, numSamples);
+
+            sampleCounter += numSamples;
+            return;
+        }
+
+        const auto latency = getLatencySamples();
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // Linked peak across channels (and across the oversampled points in true-peak mode)
+            SampleType peak = 0;
+
+            for (int ch = 0; ch < channelsToProcess; ++ch)
+            {
+                const auto* detection = detectionBlock.getChannelPointer ((size_t) ch) + i * oversampling;
+
+                for (int k = 0; k < oversampling; ++k)
+                    peak = juce::jmax (peak, std::abs (detection[k]));
+            }
+
+            const auto targetGain = peak > threshold ? threshold / peak : SampleType (1);
+            const auto gain = computeGain (targetGain);
+
+            if (gain < SampleType (1))
+            {
+                ++reducedSamples;
+                lowestGain = juce::jmin (lowestGain, gain);
+            }
+
+            if (latency > 0)
+            {
+                for (int ch = 0; ch < channelsToProcess; ++ch)
+                {
+                    auto* samples = block.getChannelPointer ((size_t) ch);
+                    auto* delayed = delayBuffer.getWritePointer (ch);
+                    const auto input = samples[i];
+
+                    samples[i] = delayed[delayWritePosition] * gain;
+                    delayed[delayWritePosition] = input;
+                }
+
+                if (++delayWritePosition >= latency)
+                    delayWritePosition = 0;
+            }
+            else
+            {
+                for (int ch = 0; ch < channelsToProcess; ++ch)
+                    block.getChannelPointer ((size_t) ch)[i] *= gain;
+            }
+        }
+    }
+
+    /** Turns the required gain for the newest sample into the gain for the sample
+        leaving the delay line: minimum over the hold window, averaged over the same
+        window so the reduction ramps in, then an exponential release.
+    */
+    SampleType computeGain (SampleType targetGain) noexcept
+    {
+        const auto window = (int64_t) holdSamples + 1;
+        const auto capacity = holdSamples + 1;
+
+        // Sliding minimum over the last `window` targets (monotonic queue)
+        if (queueSize > 0 && minimumQueue[(size_t) queueHead].index <= sampleCounter - window)
+        {
+            queueHead = (queueHead + 1) % capacity;
+            --queueSize;
+        }
+
+        while (queueSize > 0 && minimumQueue[(size_t) ((queueHead + queueSize - 1) % capacity)].value >= targetGain)
+            --queueSize;
+
+        minimumQueue[(size_t) ((queueHead + queueSize) % capacity)] = { sampleCounter, targetGain };
+        ++queueSize;
+
+        const auto minimum = minimumQueue[(size_t) queueHead].value;
+
+        // Moving average over the same window
+        averageSum += (double) minimum - (double) averageBuffer[(size_t) averagePosition];
+        averageBuffer[(size_t) averagePosition] = minimum;
+        averagePosition = (averagePosition + 1) % capacity;
+
+        const auto smoothed = (SampleType) (averageSum / (double) window);
+
+        // Instant attack, exponential release
+        envelope = smoothed < envelope ? smoothed
+                                       : smoothed + (envelope - smoothed) * releaseCoefficient;
+
+        // Snap to unity once the remaining reduction is inaudible (< 0.001 dB)
+        if (envelope > SampleType (1) - SampleType (1.0e-4))
+            envelope = SampleType (1);
+
+        if (targetGain < SampleType (1))
+            samplesWithoutReduction = 0;
+        else if (samplesWithoutReduction < std::numeric_limits<int>::max())
+            ++samplesWithoutReduction;
+
+        ++sampleCounter;
+
+        return envelope;
+    }
+
+    /** True when neither the envelope nor anything in the hold windows is reducing gain. */
+    bool isReleased() const noexcept
+    {
+        return envelope >= SampleType (1) && samplesWithoutReduction > 2 * (holdSamples + 1);
+    }
+
+    static SampleType getPeak (const juce::dsp::AudioBlock<SampleType>& block, int channelsToProcess) noexcept
+    {
+        SampleType peak = 0;
+
+        for (int ch = 0; ch < channelsToProcess; ++ch)
+        {
+            const auto range = juce::FloatVectorOperations::findMinAndMax (block.getChannelPointer ((size_t) ch),
+                                                                           (int) block.getNumSamples());
+            peak = juce::jmax (peak, -range.getStart(), range.getEnd());
+        }
+
+        return peak;
+    }
+
+    void delaySamples (const juce::dsp::AudioBlock<SampleType>& block, int channelsToProcess, int numSamples) noexcept
+    {
+        const auto latency = getLatencySamples();
+        auto position = delayWritePosition;
+
+        for (int ch = 0; ch < channelsToProcess; ++ch)
+        {
+            auto* samples = block.getChannelPointer ((size_t) ch);
+            auto* delayed = delayBuffer.getWritePointer (ch);
+            position = delayWritePosition;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                std::swap (samples[i], delayed[position]);
+
+                if (++position >= latency)
+                    position = 0;
+            }
+        }
+
+        delayWritePosition = position;
+    }
+
+    int getHoldSamples (bool useTruePeak, double lookaheadTimeMs) const noexcept
+    {
+        return juce::jlimit (0, maxHoldSamples - 1, juce::roundToInt (lookaheadTimeMs * 0.001 * sampleRate))
+             + (useTruePeak ? 1 : 0);
+    }
+
+    void updateRelease() noexcept
+    {
+        releaseCoefficient = (SampleType) std::exp (-1.0 / (juce::jmax (0.001, (double) releaseMs) * 0.001 * sampleRate));
+    }
+
+    //==============================================================================
+    struct QueueEntry
+    {
+        int64_t index;
+        SampleType value;
+    };
+
+    double sampleRate = 44100.0;
+    int numChannels = 0, maxBlockSize = 0;
+
+    SampleType threshold = 1, releaseMs = 5, releaseCoefficient = 0;
+    bool truePeak = false;
+    double lookaheadMs = 0;
+    int holdSamples = 0, maxHoldSamples = 1, truePeakLatency = 0;
+
+    std::unique_ptr<juce::dsp::Oversampling<SampleType>> truePeakDetector;
+
+    juce::AudioBuffer<SampleType> delayBuffer;
+    int delayWritePosition = 0;
+
+    juce::HeapBlock<QueueEntry> minimumQueue;
+    int queueHead = 0, queueSize = 0;
+
+    juce::HeapBlock<SampleType> averageBuffer;
+    int averagePosition = 0;
+    double averageSum = 0;
+
+    SampleType envelope = 1;
+    int samplesWithoutReduction = 0;
+
+    int reducedSamples = 0;
+    SampleType lowestGain = 1;
+    int64_t sampleCounter = 0;
+};
@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    Timestamped parameter changes for the next processBlock call.
+
+    JUCE's plugin wrappers hand the processor one value per parameter per
+    block, so automation on its own is block-quantised. Code that does know
+    where inside the block each change lands (a host adapter forwarding VST3
+    parameter queues, the offline renderer, tests) adds the points here and
+    the processor splits the block at them, running the fast block path on
+    every segment in between.
+
+    Fixed capacity and no locking: it's filled and drained on the audio
+    thread, between and during processBlock calls.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+class ParameterEventQueue
+{
+public:
+    struct Event
+    {
+        int sampleOffset = 0;    // Into the next block
+        int parameterIndex = 0;  // As in AudioProcessor::getParameters()
+        float value = 0.0f;      // Raw (denormalised) value
+    };
+
+    static constexpr int capacity = 512;
+
+    //==============================================================================
+    /** Adds an event, keeping the queue ordered by offset; events at the same offset
+        stay in the order they were added. Returns false (and drops it) when full.
+    */
+    bool add (int sampleOffset, int parameterIndex, float value) noexcept
+    {
+        if (numEvents >= capacity)
+            return false;
+
+        sampleOffset = juce::jmax (0, sampleOffset);
+
+        // Hosts send points in order, so this normally doesn't move anything
+        auto index = numEvents++;
+
+        while (index > 0 && events[(size_t) index - 1].sampleOffset > sampleOffset)
+        {
+            events[(size_t) index] = events[(size_t) index - 1];
+            --index;
+        }
+
+        events[(size_t) index] = { sampleOffset, parameterIndex, value };
+        return true;
+    }
+
+    void clear() noexcept                               { numEvents = 0; }
+
+    bool isEmpty() const noexcept                       { return numEvents == 0; }
+    int size() const noexcept                           { return numEvents; }
+    const Event& operator[] (int index) const noexcept  { return events[(size_t) index]; }
+
+    const Event* begin() const noexcept                 { return events.data(); }
+    const Event* end() const noexcept                   { return events.data() + numEvents; }
+
+private:
+    std::array<Event, capacity> events;
+    int numEvents = 0;
+};
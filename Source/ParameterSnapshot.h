@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+    Consistent, lock-free view of every parameter for the audio thread.
+
+    Parameter changes (from the host, the editor or a state load) are copied
+    into an array of atomic values, and a change counter moves with each of
+    them. The audio thread reads the whole array once per block without
+    locking or allocating; when the counter hasn't moved since the last block,
+    nothing needs reading at all.
+
+    A single change is one atomic store, so no writer ever waits; hosts call
+    back with automation on the audio thread itself. A batch (a state or
+    preset load) collects its changes in a staging array of its own and
+    publishes them when it ends, under a sequence lock that only covers that
+    copy. A read that overlaps a publish fails rather than returning half of
+    it, and the caller keeps the values it already had until the next block.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <atomic>
+
+class ParameterSnapshot : private juce::AudioProcessorParameter::Listener
+{
+public:
+    static constexpr int maxParameters = 64;
+
+    /** Raw (denormalised) values indexed by parameter index, plus the version they were read at. */
+    struct Values
+    {
+        std::array<float, maxParameters> raw {};
+        juce::uint32 version = 0;
+
+        float get (const juce::RangedAudioParameter* parameter, float fallback) const noexcept
+        {
+            return parameter != nullptr ? raw[(size_t) parameter->getParameterIndex()] : fallback;
+        }
+    };
+
+    //==============================================================================
+    ~ParameterSnapshot() override
+    {
+        for (int i = 0; i < numParameters; ++i)
+            parameters[(size_t) i]->removeListener (this);
+    }
+
+    /** Starts tracking the processor's parameters. Call once, from the processor's constructor. */
+    void attach (const juce::Array<juce::AudioProcessorParameter*>& parametersToTrack)
+    {
+        jassert (numParameters == 0 && parametersToTrack.size() <= maxParameters);
+
+        for (auto* parameter : parametersToTrack)
+        {
+            auto* ranged = dynamic_cast<juce::RangedAudioParameter*> (parameter);
+            jassert (ranged != nullptr && ranged->getParameterIndex() == numParameters);
+
+            parameters[(size_t) numParameters] = ranged;
+            values[(size_t) numParameters].store (ranged->convertFrom0to1 (ranged->getValue()));
+            ranged->addListener (this);
+            ++numParameters;
+        }
+    }
+
+    //==============================================================================
+    /** Current version: changes whenever any parameter does. Cheap enough to poll every block. */
+    juce::uint32 getVersion() const noexcept    { return version.load (std::memory_order_acquire); }
+
+    /** Audio thread: copies every value. Wait-free apart from a few bounded retries.
+        Returns false, leaving dest as it was, if every attempt overlapped a batch
+        being published; the version will have moved, so the next block reads again.
+    */
+    bool read (Values& dest) const noexcept
+    {
+        constexpr int maxAttempts = 4;
+        Values copy;
+
+        for (int attempt = 0; attempt < maxAttempts; ++attempt)
+        {
+            const auto before = publishSequence.load (std::memory_order_acquire);
+            copy.version = version.load (std::memory_order_acquire);
+
+            for (int i = 0; i < numParameters; ++i)
+                copy.raw[(size_t) i] = values[(size_t) i].load (std::memory_order_relaxed);
+
+            std::atomic_thread_fence (std::memory_order_acquire);
+
+            // Consistent if no publish started or finished while copying
+            if (before == publishSequence.load (std::memory_order_relaxed) && (before & 1) == 0)
+            {
+                dest = copy;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //==============================================================================
+    /** Groups every parameter change made on this thread while it exists into one
+        write, so the audio thread sees all of them or none (e.g. when loading state).
+        Batches on other threads wait for this one; single changes never do.
+    */
+    class ScopedBatch
+    {
+    public:
+        explicit ScopedBatch (ParameterSnapshot& s) : snapshot (s)
+        {
+            snapshot.batchLock.enter();
+
+            // The lock is re-entrant: a nested batch publishes its own changes when it ends
+            previous = snapshot.activeBatch;
+            snapshot.activeBatch = this;
+            snapshot.batchThread.store (juce::Thread::getCurrentThreadId());
+        }
+
+        ~ScopedBatch()
+        {
+            snapshot.publish (*this);
+
+            snapshot.activeBatch = previous;
+            snapshot.batchThread.store (previous != nullptr ? juce::Thread::getCurrentThreadId() : nullptr);
+            snapshot.batchLock.exit();
+        }
+
+    private:
+        friend class ParameterSnapshot;
+
+        ParameterSnapshot& snapshot;
+        ScopedBatch* previous = nullptr;
+        std::array<float, maxParameters> staged {};
+        std::array<bool, maxParameters> isStaged {};
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedBatch)
+    };
+
+private:
+    //==============================================================================
+    void parameterValueChanged (int parameterIndex, float newValue) override
+    {
+        if (! juce::isPositiveAndBelow (parameterIndex, numParameters))
+            return;
+
+        const auto raw = parameters[(size_t) parameterIndex]->convertFrom0to1 (newValue);
+
+        // Inside a batch on this thread: staged until the batch ends. Only the batch's
+        // own thread ever touches activeBatch.
+        if (batchThread.load() == juce::Thread::getCurrentThreadId())
+        {
+            activeBatch->staged[(size_t) parameterIndex] = raw;
+            activeBatch->isStaged[(size_t) parameterIndex] = true;
+            return;
+        }
+
+        values[(size_t) parameterIndex].store (raw, std::memory_order_relaxed);
+        version.fetch_add (1, std::memory_order_release);
+    }
+
+    void parameterGestureChanged (int, bool) override {}
+
+    // Called with batchLock held, so publishes never overlap
+    void publish (const ScopedBatch& batch) noexcept
+    {
+        publishSequence.fetch_add (1, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+
+        for (int i = 0; i < numParameters; ++i)
+            if (batch.isStaged[(size_t) i])
+                values[(size_t) i].store (batch.staged[(size_t) i], std::memory_order_relaxed);
+
+        publishSequence.fetch_add (1, std::memory_order_release);
+        version.fetch_add (1, std::memory_order_release);
+    }
+
+    //==============================================================================
+    std::array<juce::RangedAudioParameter*, maxParameters> parameters {};
+    std::array<std::atomic<float>, maxParameters> values {};
+    int numParameters = 0;
+
+    std::atomic<juce::uint32> version { 0 };            // Moves with every change
+    std::atomic<juce::uint32> publishSequence { 0 };    // Odd while a batch is being published
+    juce::CriticalSection batchLock;                    // Held by batches only, never by the audio thread
+    std::atomic<juce::Thread::ThreadID> batchThread { nullptr };
+    ScopedBatch* activeBatch = nullptr;
+};
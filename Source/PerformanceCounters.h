@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+
+    Real-time safe instrumentation of the processor's audio callback.
+
+    The audio thread only ever stores to atomics: no locks, allocations or
+    system calls besides reading the high resolution clock. Any other thread
+    (the editor, a test, a host-side monitor) can take a Snapshot at any time.
+    Individual values are consistent on their own, but a Snapshot may mix
+    values from two neighbouring blocks.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+
+class PerformanceCounters
+{
+public:
+    //==============================================================================
+    struct Snapshot
+    {
+        double lastBlockSeconds = 0.0;    // CPU time of the most recent block
+        double worstBlockSeconds = 0.0;   // Longest block since prepare() or resetWorstCase()
+        double budgetRatio = 0.0;         // Last block time / real-time duration of the block
+        double worstBudgetRatio = 0.0;    // Highest budgetRatio since prepare() or resetWorstCase()
+        double averageBudgetRatio = 0.0;  // Smoothed over roughly the last second
+        double smoothingPercent = 0.0;    // Share of samples processed while parameters ramped
+        double limitingPercent = 0.0;     // Share of samples the output limiter turned down
+        float limiterGainReductionDb = 0; // Deepest limiter reduction in the most recent block
+        juce::uint64 numBlocks = 0;
+        juce::uint64 numOverruns = 0;     // Blocks that took longer than their real-time budget
+    };
+
+    //==============================================================================
+    /** Sets the real-time budget and clears everything. Call from prepareToPlay. */
+    void prepare (double newSampleRate, int maximumBlockSize) noexcept
+    {
+        sampleRate = newSampleRate;
+
+        // Blocks per second at the host's block size sets the averaging time
+        const auto blocksPerSecond = newSampleRate / juce::jmax (1, maximumBlockSize);
+        averageCoefficient = 1.0 / juce::jmax (1.0, blocksPerSecond);
+
+        lastBlockSeconds.store (0.0);
+        worstBlockSeconds.store (0.0);
+        budgetRatio.store (0.0);
+        worstBudgetRatio.store (0.0);
+        averageBudgetRatio.store (0.0);
+        totalSamples.store (0);
+        smoothingSamples.store (0);
+        limitedSamples.store (0);
+        limiterGainReductionDb.store (0.0f);
+        numBlocks.store (0);
+        numOverruns.store (0);
+    }
+
+    /** Clears the worst-case values. Safe to call from any thread. */
+    void resetWorstCase() noexcept
+    {
+        worstBlockSeconds.store (0.0, std::memory_order_relaxed);
+        worstBudgetRatio.store (0.0, std::memory_order_relaxed);
+    }
+
+    //==============================================================================
+    /** Call at the very start of the audio callback. */
+    static juce::int64 beginBlock() noexcept
+    {
+        return juce::Time::getHighResolutionTicks();
+    }
+
+    /** Call at the very end of the audio callback with what happened in the block. */
+    void endBlock (juce::int64 startTicks, int numSamples, bool parametersSmoothing,
+                   int limiterReducedSamples, float limiterReductionDb) noexcept
+    {
+        const auto elapsed = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+        const auto budget = numSamples / sampleRate;
+        const auto ratio = budget > 0.0 ? elapsed / budget : 0.0;
+
+        // Only the audio thread writes these, so load/store is enough; resetWorstCase()
+        // racing with an update just means the reset takes effect a block later
+        lastBlockSeconds.store (elapsed, std::memory_order_relaxed);
+        budgetRatio.store (ratio, std::memory_order_relaxed);
+
+        if (elapsed > worstBlockSeconds.load (std::memory_order_relaxed))
+            worstBlockSeconds.store (elapsed, std::memory_order_relaxed);
+
+        if (ratio > worstBudgetRatio.load (std::memory_order_relaxed))
+            worstBudgetRatio.store (ratio, std::memory_order_relaxed);
+
+        const auto average = averageBudgetRatio.load (std::memory_order_relaxed);
+        averageBudgetRatio.store (average + (ratio - average) * averageCoefficient, std::memory_order_relaxed);
+
+        totalSamples.store (totalSamples.load (std::memory_order_relaxed) + (juce::uint64) numSamples, std::memory_order_relaxed);
+
+        if (parametersSmoothing)
+            smoothingSamples.store (smoothingSamples.load (std::memory_order_relaxed) + (juce::uint64) numSamples, std::memory_order_relaxed);
+
+        limitedSamples.store (limitedSamples.load (std::memory_order_relaxed) + (juce::uint64) limiterReducedSamples, std::memory_order_relaxed);
+        limiterGainReductionDb.store (limiterReductionDb, std::memory_order_relaxed);
+
+        if (ratio > 1.0)
+            numOverruns.store (numOverruns.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        numBlocks.store (numBlocks.load (std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    //==============================================================================
+    /** Reads the current values. Safe to call from any thread. */
+    Snapshot getSnapshot() const noexcept
+    {
+        Snapshot s;
+        s.numBlocks = numBlocks.load (std::memory_order_acquire);
+        s.lastBlockSeconds = lastBlockSeconds.load (std::memory_order_relaxed);
+        s.worstBlockSeconds = worstBlockSeconds.load (std::memory_order_relaxed);
+        s.budgetRatio = budgetRatio.load (std::memory_order_relaxed);
+        s.worstBudgetRatio = worstBudgetRatio.load (std::memory_order_relaxed);
+        s.averageBudgetRatio = averageBudgetRatio.load (std::memory_order_relaxed);
+        s.limiterGainReductionDb = limiterGainReductionDb.load (std::memory_order_relaxed);
+        s.numOverruns = numOverruns.load (std::memory_order_relaxed);
+
+        if (const auto total = totalSamples.load (std::memory_order_relaxed); total > 0)
+        {
+            s.smoothingPercent = 100.0 * (double) smoothingSamples.load (std::memory_order_relaxed) / (double) total;
+            s.limitingPercent = 100.0 * (double) limitedSamples.load (std::memory_order_relaxed) / (double) total;
+        }
+
+        return s;
+    }
+
+private:
+    //==============================================================================
+    double sampleRate = 44100.0, averageCoefficient = 1.0;
+
+    std::atomic<double> lastBlockSeconds { 0.0 }, worstBlockSeconds { 0.0 };
+    std::atomic<double> budgetRatio { 0.0 }, worstBudgetRatio { 0.0 }, averageBudgetRatio { 0.0 };
+    std::atomic<juce::uint64> totalSamples { 0 }, smoothingSamples { 0 }, limitedSamples { 0 };
+    std::atomic<float> limiterGainReductionDb { 0.0f };
+    std::atomic<juce::uint64> numBlocks { 0 }, numOverruns { 0 };
+
+    static_assert (std::atomic<double>::is_always_lock_free && std::atomic<juce::uint64>::is_always_lock_free,
+                   "Performance counters must not lock on the audio thread");
+};
@@ -11,22 +11,39 @@
 
 //==============================================================================
 NewPluginSkeletonAudioProcessorEditor::NewPluginSkeletonAudioProcessorEditor (NewPluginSkeletonAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), audioProcessor (p), spectrumAnalyser (p)
 {
     // Set custom look and feel
     setLookAndFeel(&modernLookAndFeel);
     
+    // Parameter values the timer and the response curve read (needed before setSize)
+    cutoffValue = audioProcessor.parameters.getRawParameterValue("cutoff");
+    resonanceValue = audioProcessor.parameters.getRawParameterValue("resonance");
+    gainValue = audioProcessor.parameters.getRawParameterValue("gain");
+    slopeValue = audioProcessor.parameters.getRawParameterValue("filterSlope");
+    filterTypeValue = audioProcessor.parameters.getRawParameterValue("filterType");
+    stereoModeValue = audioProcessor.parameters.getRawParameterValue("stereoMode");
+    
     // Configure main window - fixed size
-    setSize(600, 450);
+    setSize(600, 560);
     setResizable(false, false);
     
+    // Spectrum analyser first, so every other component sits on top of it
+    addAndMakeVisible(spectrumAnalyser);
+    
     // Title label
     titleLabel.setText("Franky's Filters", juce::dontSendNotification);
     titleLabel.setFont(juce::Font(24.0f, juce::Font::bold));
     titleLabel.setJustificationType(juce::Justification::centredLeft);
     addAndMakeVisible(titleLabel);
     
-    // Preset management components
+    // Preset management components. The list comes from the preset index, which reads
+    // the library on a background thread, so opening the editor never waits on the disk.
+    presetSearchBox.setTextToShowWhenEmpty("Search...", juce::Colours::grey);
+    presetSearchBox.setTooltip("Filter presets by name or tag; add type:<type> or slope:<dB> to narrow down");
+    presetSearchBox.onTextChange = [this]() { updatePresetComboBox(); };
+    addAndMakeVisible(presetSearchBox);
+    
     presetComboBox.setTextWhenNoChoicesAvailable("No Presets");
     presetComboBox.setTextWhenNothingSelected("Select Preset...");
     addAndMakeVisible(presetComboBox);
@@ -40,27 +57,19 @@ NewPluginSkeletonAudioProcessorEditor::NewPluginSkeletonAudioProcessorEditor (Ne
     addAndMakeVisible(loadPresetButton);
     
     presetComboBox.onChange = [this]() {
-        if (presetComboBox.getSelectedItemIndex() >= 0)
-        {
-            auto presetName = presetComboBox.getItemText(presetComboBox.getSelectedItemIndex());
-            auto presetFile = getPresetDirectory().getChildFile(presetName + ".xml");
-            if (presetFile.existsAsFile())
-            {
-                auto xml = juce::parseXML(presetFile);
-                if (xml != nullptr)
-                {
-                    auto valueTree = juce::ValueTree::fromXml(*xml);
-                    audioProcessor.parameters.replaceState(valueTree);
-                    updateButtonStates(); // Update button states after loading preset
-                }
-            }
-        }
+        // Loads from the values already in the index; no file is read here
+        const auto index = presetComboBox.getSelectedItemIndex();
+        if (juce::isPositiveAndBelow(index, static_cast<int>(presetResults.size())))
+            applyPreset(*presetResults[static_cast<size_t>(index)]);
     };
     
-    // Create preset directory and update combo box
-    createPresetDirectory();
+    presetIndex->addChangeListener(this);
     updatePresetComboBox();
     
+    // Right-clicking the preset list assigns the selected preset to a morph slot
+    presetComboBox.setTooltip("Right-click to use the selected preset as a morph snapshot");
+    presetComboBox.addMouseListener(this, false);
+    
     // Cutoff slider
     cutoffSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
     cutoffSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
@@ -100,25 +109,65 @@ NewPluginSkeletonAudioProcessorEditor::NewPluginSkeletonAudioProcessorEditor (Ne
     gainValueLabel.setJustificationType(juce::Justification::centred);
     addAndMakeVisible(gainValueLabel);
     
+    // Morph knobs (only move the filter while morph snapshots are set)
+    morphSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
+    morphSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    morphSlider.setPopupDisplayEnabled(true, true, this);
+    morphSlider.setTooltip("Blends from morph snapshot A to B; right-click the preset list to set them");
+    addAndMakeVisible(morphSlider);
+    
+    morphLabel.setText("Morph", juce::dontSendNotification);
+    morphLabel.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(morphLabel);
+    
+    morphYSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
+    morphYSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    morphYSlider.setPopupDisplayEnabled(true, true, this);
+    morphYSlider.setTooltip("Blends towards morph snapshots C and D");
+    addAndMakeVisible(morphYSlider);
+    
+    morphYLabel.setText("Morph Y", juce::dontSendNotification);
+    morphYLabel.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(morphYLabel);
+    
+    // Stereo mode, with the choices the parameter has (the attachment maps item n + 1 to index n)
+    stereoModeLabel.setText("Stereo Mode", juce::dontSendNotification);
+    stereoModeLabel.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(stereoModeLabel);
+    
+    if (auto* stereoModeParam = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.parameters.getParameter("stereoMode")))
+        stereoModeBox.addItemList(stereoModeParam->choices, 1);
+    stereoModeBox.setTooltip("L/R gives the right channel, and Mid/Side the side, its own cutoff, resonance and gain");
+    addAndMakeVisible(stereoModeBox);
+    
+    // Second filter set knobs (only active while the stereo mode isn't linked)
+    for (auto [slider, label, text] : { std::make_tuple(&cutoff2Slider, &cutoff2Label, "Cutoff R/S"),
+                                        std::make_tuple(&resonance2Slider, &resonance2Label, "Resonance R/S"),
+                                        std::make_tuple(&gain2Slider, &gain2Label, "Gain R/S") })
+    {
+        slider->setSliderStyle(juce::Slider::RotaryVerticalDrag);
+        slider->setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+        slider->setPopupDisplayEnabled(true, true, this);
+        addAndMakeVisible(*slider);
+        
+        label->setText(text, juce::dontSendNotification);
+        label->setJustificationType(juce::Justification::centred);
+        addAndMakeVisible(*label);
+    }
+    
     // Slope buttons
     slopeLabel.setText("Slope", juce::dontSendNotification);
     slopeLabel.setJustificationType(juce::Justification::centred);
     addAndMakeVisible(slopeLabel);
     
-    slope6dBButton.setButtonText("6 dB/oct");
-    slope6dBButton.setRadioGroupId(1);
-    slope6dBButton.setClickingTogglesState(true);
-    addAndMakeVisible(slope6dBButton);
-    
-    slope12dBButton.setButtonText("12 dB/oct");
-    slope12dBButton.setRadioGroupId(1);
-    slope12dBButton.setClickingTogglesState(true);
-    addAndMakeVisible(slope12dBButton);
-    
-    slope24dBButton.setButtonText("24 dB/oct");
-    slope24dBButton.setRadioGroupId(1);
-    slope24dBButton.setClickingTogglesState(true);
-    addAndMakeVisible(slope24dBButton);
+    for (size_t i = 0; i < slopeButtons.size(); ++i)
+    {
+        auto& button = slopeButtons[i];
+        button.setButtonText(juce::String(FilterDesign::slopeDecibelsPerOctave[i]) + " dB/oct");
+        button.setRadioGroupId(1);
+        button.setClickingTogglesState(true);
+        addAndMakeVisible(button);
+    }
     
     // Filter type buttons
     filterTypeLabel.setText("Filter Type", juce::dontSendNotification);
@@ -147,19 +196,23 @@ NewPluginSkeletonAudioProcessorEditor::NewPluginSkeletonAudioProcessorEditor (Ne
         audioProcessor.parameters, "resonance", resonanceSlider);
     gainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         audioProcessor.parameters, "gain", gainSlider);
+    morphAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.parameters, "morph", morphSlider);
+    morphYAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.parameters, "morphY", morphYSlider);
+    stereoModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.parameters, "stereoMode", stereoModeBox);
+    cutoff2Attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.parameters, "cutoff2", cutoff2Slider);
+    resonance2Attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.parameters, "resonance2", resonance2Slider);
+    gain2Attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.parameters, "gain2", gain2Slider);
     
     // Set initial button states based on parameters
-    auto* slopeParam = audioProcessor.parameters.getParameter("slope");
-    if (slopeParam)
-    {
-        int slopeIndex = static_cast<int>(slopeParam->getValue() * 2.0f);
-        switch (slopeIndex)
-        {
-            case 0: slope6dBButton.setToggleState(true, juce::dontSendNotification); break;
-            case 1: slope12dBButton.setToggleState(true, juce::dontSendNotification); break;
-            case 2: slope24dBButton.setToggleState(true, juce::dontSendNotification); break;
-        }
-    }
+    const int initialSlopeIndex = juce::roundToInt(slopeValue->load());
+    if (juce::isPositiveAndBelow(initialSlopeIndex, FilterDesign::numSlopes))
+        slopeButtons[static_cast<size_t>(initialSlopeIndex)].setToggleState(true, juce::dontSendNotification);
     
     auto* filterTypeParam = audioProcessor.parameters.getParameter("filterType");
     if (filterTypeParam)
@@ -174,20 +227,16 @@ NewPluginSkeletonAudioProcessorEditor::NewPluginSkeletonAudioProcessorEditor (Ne
     }
     
     // Add button listeners
-    slope6dBButton.onClick = [this]() {
-        if (slope6dBButton.getToggleState())
-            audioProcessor.parameters.getParameter("slope")->setValueNotifyingHost(0.0f);
-    };
-    
-    slope12dBButton.onClick = [this]() {
-        if (slope12dBButton.getToggleState())
-            audioProcessor.parameters.getParameter("slope")->setValueNotifyingHost(0.5f);
-    };
-    
-    slope24dBButton.onClick = [this]() {
-        if (slope24dBButton.getToggleState())
-            audioProcessor.parameters.getParameter("slope")->setValueNotifyingHost(1.0f);
-    };
+    for (size_t i = 0; i < slopeButtons.size(); ++i)
+    {
+        slopeButtons[i].onClick = [this, i]() {
+            if (slopeButtons[i].getToggleState())
+            {
+                auto* slopeParam = audioProcessor.parameters.getParameter("filterSlope");
+                slopeParam->setValueNotifyingHost(slopeParam->convertTo0to1(static_cast<float>(i)));
+            }
+        };
+    }
     
     lowPassButton.onClick = [this]() {
         if (lowPassButton.getToggleState())
@@ -204,14 +253,28 @@ NewPluginSkeletonAudioProcessorEditor::NewPluginSkeletonAudioProcessorEditor (Ne
             audioProcessor.parameters.getParameter("filterType")->setValueNotifyingHost(1.0f);
     };
     
-    // Start timer for value label updates and button state sync
+    // Labels, buttons and the response curve only refresh when a parameter changes:
+    // the listener marks what's dirty and wakes the timer, which stops again once
+    // things are quiet. New spectrum data wakes it the same way.
+    for (const auto& parameterID : getWatchedParameterIDs())
+        audioProcessor.parameters.addParameterListener(parameterID, this);
+    
+    spectrumAnalyser.onNewLevels = [this]() { handleAsyncUpdate(); };
+    
+    updateValueLabels(allDirty);
+    updateButtonStates(allDirty);
     startTimerHz(30);
-    updateValueLabels();
-    updateButtonStates();
 }
 
 NewPluginSkeletonAudioProcessorEditor::~NewPluginSkeletonAudioProcessorEditor()
 {
+    spectrumAnalyser.onNewLevels = nullptr;
+    presetIndex->removeChangeListener(this);
+    
+    for (const auto& parameterID : getWatchedParameterIDs())
+        audioProcessor.parameters.removeParameterListener(parameterID, this);
+    
+    cancelPendingUpdate();
     setLookAndFeel(nullptr);
     stopTimer();
 }
@@ -233,6 +296,31 @@ void NewPluginSkeletonAudioProcessorEditor::paint (juce::Graphics& g)
     // Add subtle shadow below the line for depth
     g.setColour(juce::Colour(0x30000000));
     g.drawLine(20, dividerY + 1, getWidth() - 20, dividerY + 1, 1.0f);
+    
+    // Second divider above the stereo section
+    const int stereoDividerY = 450; // Match the position from resized()
+    g.setColour(juce::Colour(0xff4a5568));
+    g.drawLine(20, stereoDividerY, getWidth() - 20, stereoDividerY, 2.0f);
+    g.setColour(juce::Colour(0x30000000));
+    g.drawLine(20, stereoDividerY + 1, getWidth() - 20, stereoDividerY + 1, 1.0f);
+    
+    // Filter response (cached; rebuilt in updateResponseCurve only when settings change)
+    {
+        juce::Graphics::ScopedSaveState saveState(g);
+        g.reduceClipRegion(responseArea);
+        
+        g.setColour(juce::Colour(0x40ffffff));
+        const float zeroDecibelY = juce::jmap(0.0f, responseMinDecibels, responseMaxDecibels,
+                                              static_cast<float>(responseArea.getBottom()), static_cast<float>(responseArea.getY()));
+        g.drawHorizontalLine(juce::roundToInt(zeroDecibelY), static_cast<float>(responseArea.getX()), static_cast<float>(responseArea.getRight()));
+        
+        // Second filter set (right or side channel) underneath the first
+        g.setColour(juce::Colour(0xff1abc9c).withAlpha(0.8f));
+        g.strokePath(responsePaths[1], juce::PathStrokeType(2.0f));
+        
+        g.setColour(juce::Colour(0xfff39c12).withAlpha(0.8f));
+        g.strokePath(responsePaths[0], juce::PathStrokeType(2.0f));
+    }
 }
 
 void NewPluginSkeletonAudioProcessorEditor::resized()
@@ -242,14 +330,15 @@ void NewPluginSkeletonAudioProcessorEditor::resized()
     const int presetHeight = 25;
     const int presetButtonWidth = 60;
     const int knobSize = 100;
+    const int morphKnobSize = 60;
     const int labelHeight = 20;
     const int buttonHeight = 30;
     const int buttonWidth = 85;
     
-    // Fixed dimensions for 600x450 window
+    // Fixed dimensions for 600x560 window
     const int totalWidth = 600;
-    const int totalHeight = 450;
     const int dividerY = 260; // Position of the dividing line - moved up a bit for better balance
+    const int stereoDividerY = 450; // The stereo section sits below this one
     
     // === TOP SECTION: Title and Preset Controls ===
     
@@ -259,10 +348,15 @@ void NewPluginSkeletonAudioProcessorEditor::resized()
     
     // Preset controls on the right side of title
     const int presetStartX = margin + titleWidth + 20;
-    const int presetComboWidth = 150;
-    presetComboBox.setBounds(presetStartX, margin + 8, presetComboWidth, presetHeight);
-    savePresetButton.setBounds(presetStartX + presetComboWidth + 10, margin + 8, presetButtonWidth, presetHeight);
-    loadPresetButton.setBounds(presetStartX + presetComboWidth + presetButtonWidth + 20, margin + 8, presetButtonWidth, presetHeight);
+    const int presetSearchWidth = 100;
+    const int presetComboWidth = 110;
+    const int presetGap = 6;
+    const int presetComboX = presetStartX + presetSearchWidth + presetGap;
+    const int saveButtonX = presetComboX + presetComboWidth + presetGap;
+    presetSearchBox.setBounds(presetStartX, margin + 8, presetSearchWidth, presetHeight);
+    presetComboBox.setBounds(presetComboX, margin + 8, presetComboWidth, presetHeight);
+    savePresetButton.setBounds(saveButtonX, margin + 8, presetButtonWidth, presetHeight);
+    loadPresetButton.setBounds(saveButtonX + presetButtonWidth + presetGap, margin + 8, presetButtonWidth, presetHeight);
     
     // === ROTARY CONTROLS SECTION (Above divider line) ===
     
@@ -276,6 +370,11 @@ void NewPluginSkeletonAudioProcessorEditor::resized()
     const int totalWidthNeeded = totalKnobWidth + (knobSpacing * 2);
     const int startX = (totalWidth - totalWidthNeeded) / 2;
     
+    // Spectrum analyser and response curve fill the knob section, behind the knobs
+    spectrumAnalyser.setBounds(margin, knobSectionTop - 5, availableWidth, dividerY - knobSectionTop);
+    responseArea = spectrumAnalyser.getBounds();
+    updateResponseCurve(true);
+    
     // Cutoff
     int xPos = startX;
     cutoffLabel.setBounds(xPos, knobSectionTop, knobSize, labelHeight);
@@ -294,16 +393,25 @@ void NewPluginSkeletonAudioProcessorEditor::resized()
     gainSlider.setBounds(xPos, knobY, knobSize, knobSize);
     gainValueLabel.setBounds(xPos, knobY + knobSize + 5, knobSize, labelHeight);
     
+    // Morph and Morph Y: smaller knobs in the space either side of the main three
+    const int morphKnobY = knobY + (knobSize - morphKnobSize) / 2;
+    const int morphLeftX = (startX - morphKnobSize) / 2;
+    const int morphRightX = totalWidth - morphLeftX - morphKnobSize;
+    morphLabel.setBounds(morphLeftX - 5, morphKnobY - labelHeight, morphKnobSize + 10, labelHeight);
+    morphSlider.setBounds(morphLeftX, morphKnobY, morphKnobSize, morphKnobSize);
+    morphYLabel.setBounds(morphRightX - 5, morphKnobY - labelHeight, morphKnobSize + 10, labelHeight);
+    morphYSlider.setBounds(morphRightX, morphKnobY, morphKnobSize, morphKnobSize);
+    
     // === BUTTON CONTROLS SECTION (Below divider line) ===
     
     const int bottomSectionY = dividerY + 15; // Start just below the divider
-    const int buttonSectionHeight = totalHeight - bottomSectionY - margin;
+    const int buttonSectionHeight = stereoDividerY - bottomSectionY - margin;
     
     // Center both button groups vertically in the bottom section
     const int buttonGroupHeight = labelHeight + 10 + buttonHeight;
     const int buttonGroupY = bottomSectionY + (buttonSectionHeight - buttonGroupHeight) / 2;
     
-    // Calculate horizontal positions for centered button groups
+    // Calculate horizontal positions for centered button groups (slopes in two rows of three)
     const int slopeGroupWidth = buttonWidth * 3 + 10;
     const int filterGroupWidth = buttonWidth * 3 + 10;
     const int totalButtonWidth = slopeGroupWidth + filterGroupWidth;
@@ -312,11 +420,16 @@ void NewPluginSkeletonAudioProcessorEditor::resized()
     
     // Slope section (left group)
     const int slopeLabelX = buttonStartX;
-    slopeLabel.setBounds(slopeLabelX, buttonGroupY, slopeGroupWidth, labelHeight);
-    const int slopeButtonY = buttonGroupY + labelHeight + 10;
-    slope6dBButton.setBounds(slopeLabelX, slopeButtonY, buttonWidth, buttonHeight);
-    slope12dBButton.setBounds(slopeLabelX + buttonWidth + 5, slopeButtonY, buttonWidth, buttonHeight);
-    slope24dBButton.setBounds(slopeLabelX + (buttonWidth + 5) * 2, slopeButtonY, buttonWidth, buttonHeight);
+    const int slopeRowHeight = buttonHeight + 5;
+    const int slopeGroupY = buttonGroupY - slopeRowHeight / 2;
+    slopeLabel.setBounds(slopeLabelX, slopeGroupY, slopeGroupWidth, labelHeight);
+    const int slopeButtonY = slopeGroupY + labelHeight + 10;
+    for (size_t i = 0; i < slopeButtons.size(); ++i)
+    {
+        const int column = static_cast<int>(i) % 3, row = static_cast<int>(i) / 3;
+        slopeButtons[i].setBounds(slopeLabelX + (buttonWidth + 5) * column, slopeButtonY + slopeRowHeight * row,
+                                  buttonWidth, buttonHeight);
+    }
     
     // Filter type section (right group)
     const int filterTypeX = buttonStartX + slopeGroupWidth + buttonGroupSpacing;
@@ -325,19 +438,181 @@ void NewPluginSkeletonAudioProcessorEditor::resized()
     lowPassButton.setBounds(filterTypeX, filterButtonY, buttonWidth, buttonHeight);
     highPassButton.setBounds(filterTypeX + buttonWidth + 5, filterButtonY, buttonWidth, buttonHeight);
     bandPassButton.setBounds(filterTypeX + (buttonWidth + 5) * 2, filterButtonY, buttonWidth, buttonHeight);
+    
+    // === STEREO SECTION (Below the second divider) ===
+    
+    // Stereo mode box, then the second set's knobs, centred as one row
+    const int stereoSectionY = stereoDividerY + 5;
+    const int stereoBoxWidth = 120;
+    const int stereoColumnWidth = 100;
+    const int stereoSpacing = 30;
+    const int stereoStartX = (totalWidth - stereoBoxWidth - (stereoColumnWidth + stereoSpacing) * 3) / 2;
+    stereoModeLabel.setBounds(stereoStartX, stereoSectionY, stereoBoxWidth, labelHeight);
+    stereoModeBox.setBounds(stereoStartX, stereoSectionY + labelHeight + (morphKnobSize - presetHeight) / 2,
+                            stereoBoxWidth, presetHeight);
+    
+    xPos = stereoStartX + stereoBoxWidth + stereoSpacing;
+    for (auto [slider, label] : { std::make_pair(&cutoff2Slider, &cutoff2Label),
+                                  std::make_pair(&resonance2Slider, &resonance2Label),
+                                  std::make_pair(&gain2Slider, &gain2Label) })
+    {
+        label->setBounds(xPos, stereoSectionY, stereoColumnWidth, labelHeight);
+        slider->setBounds(xPos + (stereoColumnWidth - morphKnobSize) / 2, stereoSectionY + labelHeight,
+                          morphKnobSize, morphKnobSize);
+        xPos += stereoColumnWidth + stereoSpacing;
+    }
 }
 
 void NewPluginSkeletonAudioProcessorEditor::timerCallback()
 {
-    updateValueLabels();
-    updateButtonStates();
+    const auto flags = dirtyFlags.exchange(0);
+    
+    if (flags != 0)
+    {
+        updateValueLabels(flags);
+        updateButtonStates(flags);
+    }
+    
+    // Checked on every tick rather than only on responseDirty: an oversampling
+    // change moves the filter rate a block or two after the parameter changes.
+    // It's only a comparison unless something actually changed.
+    updateResponseCurve();
+    
+    const bool analyserChanged = spectrumAnalyser.refresh();
+    
+    // Nothing to do for a while: stop until the next change wakes us up
+    if (flags == 0 && ! analyserChanged)
+    {
+        if (++idleTicks >= idleTicksBeforeStopping)
+            stopTimer();
+    }
+    else
+    {
+        idleTicks = 0;
+    }
 }
 
-void NewPluginSkeletonAudioProcessorEditor::updateValueLabels()
+const juce::StringArray& NewPluginSkeletonAudioProcessorEditor::getWatchedParameterIDs()
 {
-    cutoffValueLabel.setText(formatCutoffValue(cutoffSlider.getValue()), juce::dontSendNotification);
-    resonanceValueLabel.setText(formatResonanceValue(resonanceSlider.getValue()), juce::dontSendNotification);
-    gainValueLabel.setText(formatGainValue(gainSlider.getValue()), juce::dontSendNotification);
+    static const juce::StringArray ids { "cutoff", "resonance", "gain", "filterSlope", "filterType", "oversampling", "alignment",
+                                         "morph", "morphY", "stereoMode", "cutoff2", "resonance2", "gain2" };
+    return ids;
+}
+
+void NewPluginSkeletonAudioProcessorEditor::parameterChanged(const juce::String& parameterID, float)
+{
+    // May be called on the audio thread (host automation): only atomics here
+    if (parameterID == "cutoff")              markDirty(cutoffDirty | responseDirty);
+    else if (parameterID == "resonance")      markDirty(resonanceDirty | responseDirty);
+    else if (parameterID == "gain")           markDirty(gainDirty);
+    else if (parameterID == "filterSlope")    markDirty(slopeDirty | responseDirty);
+    else if (parameterID == "filterType")     markDirty(filterTypeDirty | responseDirty);
+    else if (parameterID == "oversampling")   markDirty(responseDirty);
+    else if (parameterID == "alignment")      markDirty(responseDirty);
+    else if (parameterID == "stereoMode")     markDirty(stereoModeDirty | responseDirty);
+    else                                      markDirty(responseDirty);   // Morph, second filter set
+}
+
+void NewPluginSkeletonAudioProcessorEditor::markDirty(juce::uint32 flags)
+{
+    // Only the first change after the timer has caught up posts a wake-up message,
+    // the same way JUCE's parameter attachments defer to the message thread
+    if (dirtyFlags.fetch_or(flags) == 0)
+        triggerAsyncUpdate();
+}
+
+void NewPluginSkeletonAudioProcessorEditor::handleAsyncUpdate()
+{
+    idleTicks = 0;
+    
+    if (! isTimerRunning())
+        startTimerHz(30);
+}
+
+void NewPluginSkeletonAudioProcessorEditor::updateResponseCurve(bool force)
+{
+    // What the filter actually runs: with morph snapshots set, that's not what the knobs say
+    const auto filter = audioProcessor.getFilterSettings();
+    const bool linked = filter.stereoModeIndex == NewPluginSkeletonAudioProcessor::linkedStereo;
+    
+    std::array<ResponseSettings, numResponseCurves> settings;
+    for (size_t set = 0; set < (linked ? 1 : numResponseCurves); ++set)
+    {
+        settings[set].cutoff = set == 0 ? filter.cutoff : filter.cutoff2;
+        settings[set].resonance = set == 0 ? filter.resonance : filter.resonance2;
+        settings[set].slopeIndex = filter.slopeIndex;
+        settings[set].typeIndex = filter.filterTypeIndex;
+        settings[set].alignmentIndex = filter.alignmentIndex;
+        settings[set].sampleRate = audioProcessor.getFilterSampleRate();
+    }
+    
+    if (settings == responseSettings && ! force)
+        return;
+    
+    for (size_t set = 0; set < numResponseCurves; ++set)
+        if (settings[set] != responseSettings[set] || force)
+            responsePaths[set] = createResponsePath(settings[set]);
+    
+    responseSettings = settings;
+    
+    // Only the curve's area needs repainting, not the whole editor
+    repaint(responseArea);
+}
+
+juce::Path NewPluginSkeletonAudioProcessorEditor::createResponsePath(const ResponseSettings& settings) const
+{
+    juce::Path path;
+    const auto area = responseArea.toFloat();
+    
+    // A set that isn't drawn has no sample rate
+    if (area.isEmpty() || settings.sampleRate <= 0.0)
+        return path;
+    
+    // Same sections and coefficients as the processor computes for these settings
+    const auto& layout = FilterDesign::getLayout(settings.slopeIndex, settings.alignmentIndex, settings.typeIndex == 2);
+    SVFCoefficientEngine<double, FilterDesign::maxSections> engine;
+    engine.prepare(settings.sampleRate);
+    engine.update(settings.cutoff, settings.resonance, layout);
+    
+    juce::dsp::StateVariableTPTFilterType type;
+    switch (settings.typeIndex)
+    {
+        case 1: type = juce::dsp::StateVariableTPTFilterType::highpass; break;
+        case 2: type = juce::dsp::StateVariableTPTFilterType::bandpass; break;
+        default: type = juce::dsp::StateVariableTPTFilterType::lowpass; break;
+    }
+    
+    // Same log frequency axis as the spectrum analyser, one point every two pixels
+    const float frequencyRatio = SpectrumAnalyser::maxFrequency / SpectrumAnalyser::minFrequency;
+    
+    for (float x = 0.0f; x <= area.getWidth(); x += 2.0f)
+    {
+        const double frequency = SpectrumAnalyser::minFrequency * std::pow(frequencyRatio, x / area.getWidth());
+        const double magnitude = std::abs(getCascadeResponse(engine.getCoefficients(), layout.numSections, type,
+                                                             frequency, settings.sampleRate));
+        const float decibels = static_cast<float>(juce::Decibels::gainToDecibels(magnitude, -200.0));
+        
+        // Clamp slightly outside the area so the clipped line leaves cleanly at the edges
+        const float y = juce::jmap(juce::jlimit(responseMinDecibels - 6.0f, responseMaxDecibels + 6.0f, decibels),
+                                   responseMinDecibels, responseMaxDecibels, area.getBottom(), area.getY());
+        
+        if (path.isEmpty())
+            path.startNewSubPath(area.getX() + x, y);
+        else
+            path.lineTo(area.getX() + x, y);
+    }
+    
+    return path;
+}
+
+void NewPluginSkeletonAudioProcessorEditor::updateValueLabels(juce::uint32 flags)
+{
+    if ((flags & cutoffDirty) != 0)
+        cutoffValueLabel.setText(formatCutoffValue(cutoffValue->load()), juce::dontSendNotification);
+    if ((flags & resonanceDirty) != 0)
+        resonanceValueLabel.setText(formatResonanceValue(resonanceValue->load()), juce::dontSendNotification);
+    if ((flags & gainDirty) != 0)
+        gainValueLabel.setText(formatGainValue(gainValue->load()), juce::dontSendNotification);
 }
 
 juce::String NewPluginSkeletonAudioProcessorEditor::formatCutoffValue(float value)
@@ -358,31 +633,36 @@ juce::String NewPluginSkeletonAudioProcessorEditor::formatGainValue(float value)
     return juce::String(value, 1) + " dB";
 }
 
-void NewPluginSkeletonAudioProcessorEditor::updateButtonStates()
+void NewPluginSkeletonAudioProcessorEditor::updateButtonStates(juce::uint32 flags)
 {
-    // Update slope buttons based on parameter value
-    auto* slopeParam = audioProcessor.parameters.getParameter("slope");
-    if (slopeParam)
+    // Update slope buttons based on parameter value (raw values are choice indices)
+    if ((flags & slopeDirty) != 0)
     {
-        float slopeValue = slopeParam->getValue();
-        int slopeIndex = static_cast<int>(slopeValue * 2.0f + 0.5f); // Round to nearest int
+        int slopeIndex = juce::roundToInt(slopeValue->load());
         
-        slope6dBButton.setToggleState(slopeIndex == 0, juce::dontSendNotification);
-        slope12dBButton.setToggleState(slopeIndex == 1, juce::dontSendNotification);
-        slope24dBButton.setToggleState(slopeIndex == 2, juce::dontSendNotification);
+        for (size_t i = 0; i < slopeButtons.size(); ++i)
+            slopeButtons[i].setToggleState(static_cast<int>(i) == slopeIndex, juce::dontSendNotification);
     }
     
     // Update filter type buttons based on parameter value
-    auto* filterTypeParam = audioProcessor.parameters.getParameter("filterType");
-    if (filterTypeParam)
+    if ((flags & filterTypeDirty) != 0)
     {
-        float typeValue = filterTypeParam->getValue();
-        int typeIndex = static_cast<int>(typeValue * 2.0f + 0.5f); // Round to nearest int
+        int typeIndex = juce::roundToInt(filterTypeValue->load());
         
         lowPassButton.setToggleState(typeIndex == 0, juce::dontSendNotification);
         highPassButton.setToggleState(typeIndex == 1, juce::dontSendNotification);
         bandPassButton.setToggleState(typeIndex == 2, juce::dontSendNotification);
     }
+    
+    // The second set's knobs do nothing while linked
+    if ((flags & stereoModeDirty) != 0)
+    {
+        const bool linked = juce::roundToInt(stereoModeValue->load()) == NewPluginSkeletonAudioProcessor::linkedStereo;
+        
+        for (auto* component : std::initializer_list<juce::Component*> { &cutoff2Slider, &resonance2Slider, &gain2Slider,
+                                                                        &cutoff2Label, &resonance2Label, &gain2Label })
+            component->setEnabled(! linked);
+    }
 }
 
 void NewPluginSkeletonAudioProcessorEditor::savePreset()
@@ -391,6 +671,7 @@ void NewPluginSkeletonAudioProcessorEditor::savePreset()
         if (presetName.isNotEmpty())
         {
             auto presetFile = getPresetDirectory().getChildFile(presetName + ".xml");
+            presetFile.getParentDirectory().createDirectory();
             
             // Get current state from processor
             auto state = audioProcessor.parameters.copyState();
@@ -398,17 +679,9 @@ void NewPluginSkeletonAudioProcessorEditor::savePreset()
             
             if (xml != nullptr && xml->writeTo(presetFile))
             {
-                updatePresetComboBox();
-                
-                // Select the newly saved preset
-                for (int i = 0; i < presetComboBox.getNumItems(); ++i)
-                {
-                    if (presetComboBox.getItemText(i) == presetName)
-                    {
-                        presetComboBox.setSelectedItemIndex(i, juce::dontSendNotification);
-                        break;
-                    }
-                }
+                // The new preset gets selected once the index has picked it up
+                selectedPresetFile = presetFile;
+                presetIndex->rescan();
             }
         }
     });
@@ -424,24 +697,11 @@ void NewPluginSkeletonAudioProcessorEditor::loadPreset()
                             auto file = fc.getResult();
                             if (file != juce::File{})
                             {
-                                auto xml = juce::parseXML(file);
-                                
-                                if (xml != nullptr)
+                                // A file the user picked may be outside the library, so it's read directly
+                                if (auto preset = PresetIndex::readPresetFile(file, getPresetDirectory()))
                                 {
-                                    auto valueTree = juce::ValueTree::fromXml(*xml);
-                                    audioProcessor.parameters.replaceState(valueTree);
-                                    updateButtonStates(); // Update button states after loading
-                                    
-                                    // Update combo box selection
-                                    auto presetName = file.getFileNameWithoutExtension();
-                                    for (int i = 0; i < presetComboBox.getNumItems(); ++i)
-                                    {
-                                        if (presetComboBox.getItemText(i) == presetName)
-                                        {
-                                            presetComboBox.setSelectedItemIndex(i, juce::dontSendNotification);
-                                            break;
-                                        }
-                                    }
+                                    applyPreset(*preset);
+                                    updatePresetComboBox(); // Update combo box selection
                                 }
                             }
                         });
@@ -449,41 +709,91 @@ void NewPluginSkeletonAudioProcessorEditor::loadPreset()
 
 void NewPluginSkeletonAudioProcessorEditor::updatePresetComboBox()
 {
+    juce::StringArray typeChoices, slopeChoices;
+    if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.parameters.getParameter("filterType")))
+        typeChoices = choice->choices;
+    if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.parameters.getParameter("filterSlope")))
+        slopeChoices = choice->choices;
+    
+    // Searches the index in memory; the filesystem is only touched by the scanner
+    presetResults = presetIndex->search(PresetIndex::Query::parse(presetSearchBox.getText(), typeChoices, slopeChoices));
+    
     presetComboBox.clear(juce::dontSendNotification);
     
-    auto presetDir = getPresetDirectory();
-    if (presetDir.exists())
+    for (size_t i = 0; i < presetResults.size(); ++i)
     {
-        juce::Array<juce::File> presetFiles;
-        presetDir.findChildFiles(presetFiles, juce::File::findFiles, false, "*.xml");
+        const int itemId = static_cast<int>(i) + 1;
+        presetComboBox.addItem(presetResults[i]->name, itemId);
         
-        for (const auto& file : presetFiles)
-        {
-            presetComboBox.addItem(file.getFileNameWithoutExtension(), presetComboBox.getNumItems() + 1);
-        }
+        if (presetResults[i]->file == selectedPresetFile)
+            presetComboBox.setSelectedId(itemId, juce::dontSendNotification);
     }
 }
 
-juce::File NewPluginSkeletonAudioProcessorEditor::getPresetDirectory()
+void NewPluginSkeletonAudioProcessorEditor::applyPreset(const PresetIndex::Entry& preset)
 {
-    auto appDataDir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory);
-    
-#if JUCE_MAC
-    return appDataDir.getChildFile("Audio/Presets/Franky's Filters");
-#elif JUCE_WINDOWS  
-    return appDataDir.getChildFile("Franky's Filters/Presets");
-#else
-    return appDataDir.getChildFile(".FrankysFilters/Presets");
-#endif
+    audioProcessor.setParameterValues(preset.values);
+    selectedPresetFile = preset.file;
+    updateButtonStates(slopeDirty | filterTypeDirty); // Update button states after loading preset
 }
 
-void NewPluginSkeletonAudioProcessorEditor::createPresetDirectory()
+void NewPluginSkeletonAudioProcessorEditor::mouseDown(const juce::MouseEvent& e)
 {
-    auto presetDir = getPresetDirectory();
-    if (!presetDir.exists())
+    if (e.eventComponent == &presetComboBox && e.mods.isPopupMenu())
+        showMorphMenu();
+}
+
+void NewPluginSkeletonAudioProcessorEditor::showMorphMenu()
+{
+    const auto index = presetComboBox.getSelectedItemIndex();
+    const bool hasPreset = juce::isPositiveAndBelow(index, static_cast<int>(presetResults.size()));
+    const auto preset = hasPreset ? presetResults[static_cast<size_t>(index)] : nullptr;
+    
+    // Slots A and B are the Morph knob's ends; C and D add the Morph Y axis
+    const juce::StringArray slotNames { "A", "B", "C (Morph Y)", "D (Morph Y)" };
+    constexpr int clearItemId = 100;
+    
+    juce::PopupMenu menu;
+    menu.addSectionHeader(hasPreset ? "Morph: " + preset->name : juce::String("Morph: select a preset first"));
+    
+    bool anySlotSet = false;
+    for (int slot = 0; slot < slotNames.size(); ++slot)
     {
-        presetDir.createDirectory();
+        const bool isSet = audioProcessor.hasMorphSnapshot(slot);
+        anySlotSet = anySlotSet || isSet;
+        menu.addItem(slot + 1, "Use as Morph " + slotNames[slot], hasPreset, isSet);
     }
+    
+    menu.addSeparator();
+    menu.addItem(clearItemId, "Clear Morph Slots", anySlotSet);
+    
+    // The snapshot comes from the index's values, so assigning a slot never reads the preset file
+    juce::Component::SafePointer<NewPluginSkeletonAudioProcessorEditor> safeThis(this);
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&presetComboBox),
+                       [safeThis, preset](int result)
+                       {
+                           if (safeThis == nullptr || result == 0)
+                               return;
+                           
+                           if (result == clearItemId)
+                               safeThis->audioProcessor.clearMorphSnapshots();
+                           else if (preset != nullptr)
+                               safeThis->audioProcessor.setMorphSnapshot(result - 1, preset->values);
+                           
+                           // The response curve follows the morph
+                           safeThis->markDirty(responseDirty);
+                       });
+}
+
+void NewPluginSkeletonAudioProcessorEditor::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    // The index changed (a scan finished or a preset was saved)
+    updatePresetComboBox();
+}
+
+juce::File NewPluginSkeletonAudioProcessorEditor::getPresetDirectory()
+{
+    return presetIndex->getPresetDirectory();
 }
 
 juce::String NewPluginSkeletonAudioProcessorEditor::getCurrentPresetName()
@@ -10,7 +10,12 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <map>
+#include <tuple>
 #include "PluginProcessor.h"
+#include "SpectrumAnalyser.h"
+#include "PresetIndex.h"
 
 //==============================================================================
 /**
@@ -48,10 +53,93 @@ public:
     void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height, 
                          float sliderPos, float rotaryStartAngle, float rotaryEndAngle, 
                          juce::Slider& slider) override
+    {
+        // Blit a cached sprite. The angle is quantised so at most knobAngleSteps images
+        // cover every position (steps of ~2 degrees aren't visible on a knob this size).
+        const int angleStep = juce::roundToInt(juce::jlimit(0.0f, 1.0f, sliderPos) * (knobAngleSteps - 1));
+        const juce::int64 angles = juce::roundToInt(rotaryStartAngle * 1000.0f) * 100000LL + juce::roundToInt(rotaryEndAngle * 1000.0f);
+        
+        const auto& sprite = getSprite(g, rotaryKnobSprite, width, height, angleStep, angles, [&](juce::Graphics& sg)
+        {
+            paintRotaryKnob(sg, width, height, angleStep / static_cast<float>(knobAngleSteps - 1),
+                            rotaryStartAngle, rotaryEndAngle);
+        });
+        
+        g.drawImage(sprite, juce::Rectangle<int>(x, y, width, height).toFloat());
+    }
+    
+    void drawToggleButton(juce::Graphics& g, juce::ToggleButton& button, 
+                         bool shouldDrawButtonAsHighlighted, bool shouldDrawButtonAsDown) override
+    {
+        const auto text = button.getButtonText();
+        const bool isOn = button.getToggleState();
+        const int width = button.getWidth(), height = button.getHeight();
+        const int state = (isOn ? 1 : 0) | (shouldDrawButtonAsHighlighted ? 2 : 0);
+        
+        const auto& sprite = getSprite(g, toggleButtonSprite, width, height, state, text.hashCode64(), [&](juce::Graphics& sg)
+        {
+            paintToggleButton(sg, width, height, text, isOn, shouldDrawButtonAsHighlighted);
+        });
+        
+        g.drawImage(sprite, button.getLocalBounds().toFloat());
+    }
+    
+private:
+    //==============================================================================
+    // Sprite cache: knobs and buttons are rendered once per size, display scale and
+    // state into software images, and every repaint after that is a single blit
+    // instead of rebuilding gradients, paths and transforms
+    enum SpriteKind { rotaryKnobSprite, toggleButtonSprite };
+    
+    // kind, width, height, scale (in hundredths), state, detail
+    using SpriteKey = std::tuple<int, int, int, int, int, juce::int64>;
+    
+    static constexpr int knobAngleSteps = 128;
+    static constexpr size_t maxSpriteCacheBytes = 16 * 1024 * 1024;
+    
+    std::map<SpriteKey, juce::Image> spriteCache;
+    size_t spriteCacheBytes = 0;
+    
+    template <typename Painter>
+    const juce::Image& getSprite(juce::Graphics& g, SpriteKind kind, int width, int height,
+                                 int state, juce::int64 detail, Painter&& paintSprite)
+    {
+        // Render at the physical pixel density so the blit stays sharp on HiDPI screens
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        const SpriteKey key { kind, width, height, juce::roundToInt(scale * 100.0f), state, detail };
+        
+        if (auto existing = spriteCache.find(key); existing != spriteCache.end())
+            return existing->second;
+        
+        const int imageWidth = juce::jmax(1, juce::roundToInt(width * scale));
+        const int imageHeight = juce::jmax(1, juce::roundToInt(height * scale));
+        const auto imageBytes = static_cast<size_t>(imageWidth) * static_cast<size_t>(imageHeight) * 4;
+        
+        // Bounded memory: start over rather than tracking usage per entry
+        if (spriteCacheBytes + imageBytes > maxSpriteCacheBytes)
+        {
+            spriteCache.clear();
+            spriteCacheBytes = 0;
+        }
+        
+        juce::Image image(juce::Image::ARGB, imageWidth, imageHeight, true, juce::SoftwareImageType());
+        {
+            juce::Graphics spriteGraphics(image);
+            spriteGraphics.addTransform(juce::AffineTransform::scale(imageWidth / static_cast<float>(juce::jmax(1, width)),
+                                                                     imageHeight / static_cast<float>(juce::jmax(1, height))));
+            paintSprite(spriteGraphics);
+        }
+        
+        spriteCacheBytes += imageBytes;
+        return spriteCache.emplace(key, std::move(image)).first->second;
+    }
+    
+    void paintRotaryKnob(juce::Graphics& g, int width, int height, float sliderPos,
+                         float rotaryStartAngle, float rotaryEndAngle)
     {
         const float radius = juce::jmin(width / 2, height / 2) - 8.0f;
-        const float centreX = x + width * 0.5f;
-        const float centreY = y + height * 0.5f;
+        const float centreX = width * 0.5f;
+        const float centreY = height * 0.5f;
         const float rx = centreX - radius;
         const float ry = centreY - radius;
         const float rw = radius * 2.0f;
@@ -95,11 +183,10 @@ public:
                      knobRadius * 2.0f - 2, knobRadius * 2.0f - 2, 1.0f);
     }
     
-    void drawToggleButton(juce::Graphics& g, juce::ToggleButton& button, 
-                         bool shouldDrawButtonAsHighlighted, bool shouldDrawButtonAsDown) override
+    void paintToggleButton(juce::Graphics& g, int width, int height, const juce::String& text,
+                           bool isOn, bool shouldDrawButtonAsHighlighted)
     {
-        const auto bounds = button.getLocalBounds().toFloat();
-        const bool isOn = button.getToggleState();
+        const auto bounds = juce::Rectangle<int>(width, height).toFloat();
         
         // Background with gradient
         juce::ColourGradient bgGradient(isOn ? juce::Colour(0xff4a90e2) : juce::Colour(0xff34495e), 
@@ -116,7 +203,7 @@ public:
         // Text
         g.setColour(isOn ? juce::Colours::white : juce::Colour(0xffbdc3c7));
         g.setFont(juce::Font(14.0f, juce::Font::bold));
-        g.drawText(button.getButtonText(), bounds, juce::Justification::centred);
+        g.drawText(text, bounds, juce::Justification::centred);
         
         // Highlight on hover
         if (shouldDrawButtonAsHighlighted)
@@ -128,7 +215,10 @@ public:
 };
 
 class NewPluginSkeletonAudioProcessorEditor : public juce::AudioProcessorEditor,
-                                              public juce::Timer
+                                              public juce::Timer,
+                                              private juce::AudioProcessorValueTreeState::Listener,
+                                              private juce::AsyncUpdater,
+                                              private juce::ChangeListener
 {
 public:
     NewPluginSkeletonAudioProcessorEditor (NewPluginSkeletonAudioProcessor&);
@@ -137,8 +227,10 @@ public:
     //==============================================================================
     void paint (juce::Graphics&) override;
     void resized() override;
+    void mouseDown (const juce::MouseEvent&) override;
     
-    // Timer callback for meter updates
+    // Timer callback for value labels, button states and the analyser. Only runs
+    // while something is changing; see parameterChanged and handleAsyncUpdate.
     void timerCallback() override;
 
 private:
@@ -147,22 +239,39 @@ private:
     // Custom LookAndFeel
     ModernLookAndFeel modernLookAndFeel;
     
+    // Live pre/post-filter spectrum behind the knobs
+    SpectrumAnalyser spectrumAnalyser;
+    
     // UI Components
     juce::Slider cutoffSlider;
     juce::Slider resonanceSlider;
     juce::Slider gainSlider;
     
+    // Preset morph position, either side of the main knobs
+    juce::Slider morphSlider;
+    juce::Slider morphYSlider;
+    
     juce::Label cutoffLabel;
     juce::Label resonanceLabel;
     juce::Label gainLabel;
+    juce::Label morphLabel;
+    juce::Label morphYLabel;
+    
+    // Stereo mode and the second filter set (right or side channel), along the bottom
+    juce::ComboBox stereoModeBox;
+    juce::Label stereoModeLabel;
+    juce::Slider cutoff2Slider;
+    juce::Slider resonance2Slider;
+    juce::Slider gain2Slider;
+    juce::Label cutoff2Label;
+    juce::Label resonance2Label;
+    juce::Label gain2Label;
     
     juce::Label cutoffValueLabel;
     juce::Label resonanceValueLabel;
     juce::Label gainValueLabel;
     
-    juce::ToggleButton slope6dBButton;
-    juce::ToggleButton slope12dBButton;
-    juce::ToggleButton slope24dBButton;
+    std::array<juce::ToggleButton, FilterDesign::numSlopes> slopeButtons;  // One per slope choice, in order
     
     juce::ToggleButton lowPassButton;
     juce::ToggleButton highPassButton;
@@ -173,22 +282,96 @@ private:
     juce::Label filterTypeLabel;
     
     // Preset management components
+    juce::TextEditor presetSearchBox;
     juce::ComboBox presetComboBox;
     juce::TextButton savePresetButton;
     juce::TextButton loadPresetButton;
     
+    // Library index shared by every open editor; scans in the background
+    juce::SharedResourcePointer<PresetIndex> presetIndex;
+    PresetIndex::EntryList presetResults;  // What the combo box lists, in order
+    juce::File selectedPresetFile;
+    
     // Parameter attachments
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> cutoffAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> resonanceAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> gainAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> morphAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> morphYAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> stereoModeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> cutoff2Attachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> resonance2Attachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> gain2Attachment;
     
     // We need to handle slope and filter type manually since they use radio buttons
     // std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> slopeAttachment;
     // std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> filterTypeAttachment;
     
+    // Analytic magnitude response of each filter set, drawn behind the spectrum, from the
+    // settings in effect (so it follows the morph). The second set is only drawn while
+    // the stereo mode unlinks it. A path is only rebuilt when its settings change.
+    struct ResponseSettings
+    {
+        float cutoff = -1.0f, resonance = -1.0f;
+        int slopeIndex = -1, typeIndex = -1, alignmentIndex = -1;
+        double sampleRate = 0.0;
+        
+        bool operator==(const ResponseSettings& other) const
+        {
+            return cutoff == other.cutoff && resonance == other.resonance && slopeIndex == other.slopeIndex
+                && typeIndex == other.typeIndex && alignmentIndex == other.alignmentIndex && sampleRate == other.sampleRate;
+        }
+        
+        bool operator!=(const ResponseSettings& other) const { return ! (*this == other); }
+    };
+    
+    static constexpr size_t numResponseCurves = NewPluginSkeletonAudioProcessor::numFilterSets;
+    
+    std::array<ResponseSettings, numResponseCurves> responseSettings;
+    std::array<juce::Path, numResponseCurves> responsePaths;
+    juce::Rectangle<int> responseArea;
+    
+    static constexpr float responseMinDecibels = -48.0f, responseMaxDecibels = 24.0f;
+    
+    // Which widgets need refreshing. Set from parameterChanged (on whatever thread
+    // changed the parameter) and cleared by the timer on the message thread.
+    enum DirtyFlags : juce::uint32
+    {
+        cutoffDirty     = 1 << 0,
+        resonanceDirty  = 1 << 1,
+        gainDirty       = 1 << 2,
+        slopeDirty      = 1 << 3,
+        filterTypeDirty = 1 << 4,
+        responseDirty   = 1 << 5,   // Settings the response curve depends on
+        stereoModeDirty = 1 << 6,
+        allDirty        = (1 << 7) - 1
+    };
+    
+    std::atomic<juce::uint32> dirtyFlags { allDirty };
+    
+    // Timer ticks without any changes before the timer stops (half a second at 30 Hz)
+    static constexpr int idleTicksBeforeStopping = 15;
+    int idleTicks = 0;
+    
+    // Parameter values read by the timer, looked up once instead of by ID every tick
+    std::atomic<float>* cutoffValue = nullptr;
+    std::atomic<float>* resonanceValue = nullptr;
+    std::atomic<float>* gainValue = nullptr;
+    std::atomic<float>* slopeValue = nullptr;
+    std::atomic<float>* filterTypeValue = nullptr;
+    std::atomic<float>* stereoModeValue = nullptr;
+    
+    static const juce::StringArray& getWatchedParameterIDs();
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void markDirty(juce::uint32 flags);
+    void handleAsyncUpdate() override;
+    void changeListenerCallback(juce::ChangeBroadcaster*) override;
+    
     // Helper methods
-    void updateValueLabels();
-    void updateButtonStates();
+    void updateResponseCurve(bool force = false);
+    juce::Path createResponsePath(const ResponseSettings& settings) const;
+    void updateValueLabels(juce::uint32 flags);
+    void updateButtonStates(juce::uint32 flags);
     juce::String formatCutoffValue(float value);
     juce::String formatResonanceValue(float value);
     juce::String formatGainValue(float value);
@@ -197,8 +380,9 @@ private:
     void savePreset();
     void loadPreset();
     void updatePresetComboBox();
+    void applyPreset(const PresetIndex::Entry& preset);
+    void showMorphMenu();
     juce::File getPresetDirectory();
-    void createPresetDirectory();
     juce::String getCurrentPresetName();
     void setCurrentPresetName(const juce::String& name);
     void showPresetNameDialog(std::function<void(const juce::String&)> callback);
@@ -7,7 +7,9 @@
 */
 
 #include "PluginProcessor.h"
-#include "PluginEditor.h"
+#if ! (JUCE_UNIT_TESTS || FRANKYS_FILTERS_HEADLESS)
+ #include "PluginEditor.h"
+#endif
 
 //==============================================================================
 NewPluginSkeletonAudioProcessor::NewPluginSkeletonAudioProcessor()
@@ -25,13 +27,69 @@ NewPluginSkeletonAudioProcessor::NewPluginSkeletonAudioProcessor()
     // Get parameter pointers
     cutoffFreq = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("cutoff"));
     resonance = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("resonance"));
-    filterSlope = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("slope"));
+    filterSlope = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("filterSlope"));
     filterType = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("filterType"));
     gain = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("gain"));
+    truePeak = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter("truePeak"));
+    lookahead = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("lookahead"));
+    oversampling = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("oversampling"));
+    oversamplingFilter = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("oversamplingFilter"));
+    morphX = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("morph"));
+    morphY = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("morphY"));
+    filterAlignment = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("alignment"));
+    stereoMode = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter("stereoMode"));
+    cutoffFreq2 = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("cutoff2"));
+    resonance2 = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("resonance2"));
+    gain2 = dynamic_cast<juce::AudioParameterFloat*>(parameters.getParameter("gain2"));
+    
+    // Presets are saved from the state tree, so they carry the version their values are in
+    parameters.state.setProperty("version", static_cast<int>(BinaryStateFormat::currentVersion), nullptr);
+    
+    // Parameters the preset morph controls, in MorphTarget order
+    const std::initializer_list<juce::RangedAudioParameter*> morphTargets { cutoffFreq, resonance, gain, filterSlope, filterType,
+                                                                            filterAlignment, cutoffFreq2, resonance2, gain2 };
+    for (auto* parameter : morphTargets)
+    {
+        const bool stepped = dynamic_cast<juce::AudioParameterChoice*>(parameter) != nullptr;
+        morphEngine.addTarget({ parameter->getParameterID(), parameter->getNormalisableRange(),
+                                parameter->convertFrom0to1(parameter->getDefaultValue()), stepped });
+    }
+    
+    // Every parameter goes into the binary session state. Before version 3 the slope
+    // was saved as "slope", and version 1 had three slopes, whose indices have moved.
+    for (auto* parameter : getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            stateFormat.addParameter(*ranged);
+    
+    stateFormat.setLegacyID(*filterSlope, "slope");
+    stateFormat.setUpgrader(*filterSlope, [](float value, int version)
+    {
+        return version < 2 ? static_cast<float>(FilterDesign::getSlopeIndexFromVersion1(juce::roundToInt(value))) : value;
+    });
+    
+    parameters.addParameterListener("slope", this);
+    
+    // ...and into the snapshot the audio thread reads each block
+    parameterSnapshot.attach(getParameters());
 }
 
 NewPluginSkeletonAudioProcessor::~NewPluginSkeletonAudioProcessor()
 {
+    parameters.removeParameterListener("slope", this);
+}
+
+void NewPluginSkeletonAudioProcessor::parameterChanged (const juce::String&, float newValue)
+{
+    // Only the legacy slope is listened to. Called on whatever thread the host
+    // automates from; the forwarded change reaches the audio thread's snapshot
+    // before the block it was automated for.
+    if (loadingState.load())
+        return;
+    
+    const int slopeIndex = FilterDesign::getSlopeIndexFromVersion1(juce::roundToInt(newValue));
+    
+    if (filterSlope->getIndex() != slopeIndex)
+        filterSlope->setValueNotifyingHost(filterSlope->convertTo0to1(static_cast<float>(slopeIndex)));
 }
 
 //==============================================================================
@@ -69,7 +127,45 @@ bool NewPluginSkeletonAudioProcessor::isMidiEffect() const
 
 double NewPluginSkeletonAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // How long the filters ring on once the input stops, as the audio thread last worked
+    // it out (morph included). Hosts may ask from any thread, so this never locks.
+    return tailLengthSeconds.load(std::memory_order_relaxed);
+}
+
+template <typename Settings>
+void NewPluginSkeletonAudioProcessor::applyMorphedValues(const std::array<float, MorphEngine::maxTargets>& morphed, Settings& settings)
+{
+    settings.cutoff = morphed[morphCutoff];
+    settings.resonance = morphed[morphResonance];
+    settings.gain = morphed[morphGain];
+    settings.slopeIndex = juce::roundToInt(morphed[morphSlope]);
+    settings.filterTypeIndex = juce::roundToInt(morphed[morphFilterType]);
+    settings.alignmentIndex = juce::roundToInt(morphed[morphAlignment]);
+    settings.cutoff2 = morphed[morphCutoff2];
+    settings.resonance2 = morphed[morphResonance2];
+    settings.gain2 = morphed[morphGain2];
+}
+
+NewPluginSkeletonAudioProcessor::FilterSettings NewPluginSkeletonAudioProcessor::getFilterSettings() const
+{
+    FilterSettings settings;
+    settings.cutoff = cutoffFreq->get();
+    settings.resonance = resonance->get();
+    settings.gain = gain->get();
+    settings.slopeIndex = filterSlope->getIndex();
+    settings.filterTypeIndex = filterType->getIndex();
+    settings.alignmentIndex = filterAlignment->getIndex();
+    settings.stereoModeIndex = stereoMode->getIndex();
+    settings.cutoff2 = cutoffFreq2->get();
+    settings.resonance2 = resonance2->get();
+    settings.gain2 = gain2->get();
+    
+    // Worked out from the snapshots, as the audio thread's table is its own
+    std::array<float, MorphEngine::maxTargets> morphed;
+    if (morphEngine.getLatestValues(morphX->get(), morphY->get(), morphed.data()))
+        applyMorphedValues(morphed, settings);
+    
+    return settings;
 }
 
 int NewPluginSkeletonAudioProcessor::getNumPrograms()
@@ -106,33 +202,77 @@ void NewPluginSkeletonAudioProcessor::prepareToPlay (double sampleRate, int samp
     spec.numChannels = static_cast<juce::uint32>(getTotalNumOutputChannels());
     
     numChannels = getTotalNumOutputChannels();
+    currentSampleRate = sampleRate;
+    analyserSampleRate.store(sampleRate, std::memory_order_relaxed);
     
-    // Prepare all filter stages in the chain
-    for (auto& filter : filterChain)
+    maxOversamplingBlockSize = juce::jmax(1, samplesPerBlock);
+    
+    // Hosts set the processing precision before calling this, so only that core is prepared
+    withActiveCore([&](auto& core)
     {
-        filter.prepare(spec);
-        filter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-    }
+        // Prepare the filter chain and the shadow chain that carries the outgoing slope
+        // during a slope transition. Crossfades are processed in coefficient sub-blocks,
+        // so the scratch space must hold at least one of those, at the highest oversampling.
+        const int maxFilterBlockSize = juce::jmax(samplesPerBlock, core.coefficientEngines[0].updateInterval)
+                                     * FilterOversampling<float>::maxFactor;
+        core.filterChain.prepare(numChannels, maxFilterBlockSize);
+        core.shadowFilterChain.prepare(numChannels, maxFilterBlockSize);
+        
+        // Every oversampling factor and design is allocated here, so switching never allocates,
+        // along with the outgoing path a switch keeps running
+        core.filterOversampling.prepare(numChannels, maxOversamplingBlockSize);
+        core.outgoingRateFilterChain.prepare(numChannels, maxFilterBlockSize);
+        core.outgoingRateBuffer.setSize(numChannels, maxOversamplingBlockSize);
+        
+        // Prepare output limiter to prevent exceeding -0.1dB
+        core.outputLimiter.prepare(spec, maxLookaheadMs);
+        core.outputLimiter.setThreshold(-0.1f); // -0.1dB threshold
+        core.outputLimiter.setRelease(5.0f);    // Fast 5ms release time
+    });
+    
+    updateBlockParameters(true);
+    withActiveCore([this](auto& core) { core.outputLimiter.setMode(blockParameters.truePeak, blockParameters.lookaheadMs); });
     
-    // Prepare output limiter to prevent exceeding -0.1dB
-    outputLimiter.prepare(spec);
-    outputLimiter.setThreshold(-0.1f); // -0.1dB threshold
-    outputLimiter.setRelease(5.0f);    // Fast 5ms release time
+    // Real-time budget for the performance counters
+    performanceCounters.prepare(sampleRate, samplesPerBlock);
     
     // Initialize parameter smoothers
-    cutoffSmoother.reset(sampleRate, 0.05); // 50ms ramp
-    resonanceSmoother.reset(sampleRate, 0.02); // 20ms ramp
-    gainSmoother.reset(sampleRate, 0.02); // 20ms ramp
-    slopeSmoother.reset(sampleRate, 0.1); // 100ms ramp for smooth slope transitions
+    for (int set = 0; set < numFilterSets; ++set)
+    {
+        cutoffSmoothers[static_cast<size_t>(set)].reset(sampleRate, 0.05); // 50ms ramp
+        resonanceSmoothers[static_cast<size_t>(set)].reset(sampleRate, 0.02); // 20ms ramp
+    }
+    for (auto& smoother : gainSmoothers)
+        smoother.reset(sampleRate, 0.02); // 20ms ramp
+    slopeSmoother.reset(sampleRate, 0.1); // 100ms crossfade for smooth slope transitions
+    slopeSmoother.setCurrentAndTargetValue(1.0f); // No transition in progress
+    oversamplingCrossfade.reset(sampleRate, oversamplingCrossfadeSeconds);
+    oversamplingCrossfade.setCurrentAndTargetValue(1.0f);
     
     // Set initial parameter values
-    if (cutoffFreq != nullptr && resonance != nullptr && filterSlope != nullptr && gain != nullptr)
+    setFilterSetTargets();
+    for (int set = 0; set < numFilterSets; ++set)
     {
-        cutoffSmoother.setCurrentAndTargetValue(cutoffFreq->get());
-        resonanceSmoother.setCurrentAndTargetValue(resonance->get());
-        gainSmoother.setCurrentAndTargetValue(gain->get());
-        slopeSmoother.setCurrentAndTargetValue(static_cast<float>(filterSlope->getIndex()));
+        cutoffSmoothers[static_cast<size_t>(set)].setCurrentAndTargetValue(cutoffSmoothers[static_cast<size_t>(set)].getTargetValue());
+        resonanceSmoothers[static_cast<size_t>(set)].setCurrentAndTargetValue(resonanceSmoothers[static_cast<size_t>(set)].getTargetValue());
+        gainSmoothers[static_cast<size_t>(set)].setCurrentAndTargetValue(gainSmoothers[static_cast<size_t>(set)].getTargetValue());
     }
+    activeDesignIndex = outgoingDesignIndex = getDesignIndex(blockParameters.slopeIndex, blockParameters.alignmentIndex);
+    activeBandpass = blockParameters.filterTypeIndex == 2;
+    activeLayout = outgoingLayout = &getDesignLayout(activeDesignIndex, activeBandpass);
+    assignFilterSets(blockParameters.stereoModeIndex);
+    updateTailLength();
+    
+    silentInputSamples = 0;
+    sleeping.store(false, std::memory_order_relaxed);
+    
+    // Oversampling starts out at whatever the settings ask for (auto mode looks at the
+    // cutoff, so this comes after the smoothers). Also sets the coefficient engines'
+    // rate and reports the total latency.
+    oversamplingDelayLine = 0;
+    applyOversamplingSettings(getWantedOversamplingIndex(),
+                              static_cast<OversamplingDesign>(blockParameters.oversamplingFilterIndex),
+                              blockParameters.oversamplingChoice == autoOversamplingChoice);
 }
 
 void NewPluginSkeletonAudioProcessor::releaseResources()
@@ -148,12 +288,12 @@ bool NewPluginSkeletonAudioProcessor::isBusesLayoutSupported (const BusesLayout&
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any non-empty layout is supported: mono, stereo, surround and immersive beds
+    // (5.1, 7.1, 7.1.4, ...), ambisonic and discrete buses. Every channel runs the
+    // same filter (bar the second one in the L/R and Mid/Side stereo modes), and
+    // channels are processed in SIMD-register-wide groups.
+    if (layouts.getMainOutputChannelSet().isDisabled()
+     || layouts.getMainOutputChannelSet().size() > maxSupportedChannels)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -167,8 +307,29 @@ bool NewPluginSkeletonAudioProcessor::isBusesLayoutSupported (const BusesLayout&
 }
 #endif
 
+bool NewPluginSkeletonAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
 void NewPluginSkeletonAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    processBuffer(buffer);
+}
+
+void NewPluginSkeletonAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processBuffer(buffer);
+}
+
+template <typename SampleType>
+void NewPluginSkeletonAudioProcessor::processBuffer (juce::AudioBuffer<SampleType>& buffer)
+{
+    // Only the core for the precision set before prepareToPlay is prepared
+    jassert(isUsingDoublePrecision() == std::is_same_v<SampleType, double>);
+    auto& core = getCore<SampleType>();
+    
+    const auto blockStartTicks = PerformanceCounters::beginBlock();
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -177,23 +338,274 @@ void NewPluginSkeletonAudioProcessor::processBlock (juce::AudioBuffer<float>& bu
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
+    // Spectrum analyser input (wait-free; drops samples if the analyser falls behind)
+    const bool feedAnalyser = analyserEnabled.load(std::memory_order_relaxed);
+    if (feedAnalyser)
+        analyserInputFifo.push(buffer, totalNumInputChannels);
+    
+    // One consistent read of every parameter per block, skipped entirely (along with
+    // the smoother and limiter updates) when nothing has changed
+    const bool parametersChanged = updateBlockParameters();
+    
     // Update parameter smoothers
-    if (cutoffFreq != nullptr)
-        cutoffSmoother.setTargetValue(cutoffFreq->get());
-    if (resonance != nullptr)
-        resonanceSmoother.setTargetValue(resonance->get());
-    if (gain != nullptr)
-        gainSmoother.setTargetValue(gain->get());
-    if (filterSlope != nullptr)
-        slopeSmoother.setTargetValue(static_cast<float>(filterSlope->getIndex()));
-
-    // Get current parameter settings
-    int slope = filterSlope != nullptr ? filterSlope->getIndex() : 0; // Default 6dB
-    int filterTypeIndex = filterType != nullptr ? filterType->getIndex() : 0; // Default Low-pass
+    if (parametersChanged)
+    {
+        setFilterSetTargets();
+        updateLimiterMode();
+    }
+
+    // Oversampling changes crossfade from the outgoing path, which keeps running, to the
+    // new one (see processFilter). A change during a crossfade waits for it to finish.
+    const int wantedOversampling = getWantedOversamplingIndex();
+    const auto wantedDesign = static_cast<OversamplingDesign>(blockParameters.oversamplingFilterIndex);
+    const bool wantedAuto = blockParameters.oversamplingChoice == autoOversamplingChoice;
+    
+    if (! oversamplingCrossfade.isSmoothing()
+        && (wantedOversampling != activeOversamplingIndex || wantedDesign != activeOversamplingDesign
+            || wantedAuto != activeOversamplingAuto))
+        beginOversamplingSwitch<SampleType>(wantedOversampling, wantedDesign, wantedAuto);
+    
+    // Asleep: the input is still silent and nothing is left ringing, so no DSP runs
+    // at all. Parameter changes go straight to their targets in the meantime.
+    const bool inputSilent = isSilent(buffer, totalNumInputChannels);
+    
+    if (sleeping.load(std::memory_order_relaxed))
+    {
+        if (inputSilent)
+        {
+            for (const auto& event : parameterEvents)
+                applyParameterEvent(event);
+            
+            if (parameterEvents.size() > 0)
+            {
+                parameterEvents.clear();
+                updateLimiterMode();
+            }
+            
+            settleParameters();
+            updateTailLength();
+            buffer.clear();
+            
+            if (feedAnalyser)
+                analyserOutputFifo.push(buffer, totalNumInputChannels);
+            
+            performanceCounters.endBlock(blockStartTicks, buffer.getNumSamples(), false, 0, 0.0f);
+            return;
+        }
+        
+        sleeping.store(false, std::memory_order_relaxed);
+    }
+    
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+    auto filterBlock = block.getSubsetChannelBlock(0, static_cast<size_t>(totalNumInputChannels));
+    
+    // Split the block at automation points; without any this is one segment
+    const int numSamples = buffer.getNumSamples();
+    const int numEvents = parameterEvents.size();
+    bool parametersSmoothing = false;
+    
+    for (int segmentStart = 0, eventIndex = 0; segmentStart < numSamples || eventIndex < numEvents;)
+    {
+        while (eventIndex < numEvents && (parameterEvents[eventIndex].sampleOffset <= segmentStart
+                                          || segmentStart >= numSamples))
+            applyParameterEvent(parameterEvents[eventIndex++]);
+        
+        const int segmentEnd = eventIndex < numEvents ? juce::jmin(numSamples, parameterEvents[eventIndex].sampleOffset)
+                                                      : numSamples;
+        
+        if (segmentEnd > segmentStart)
+            parametersSmoothing |= processSegment(filterBlock.getSubBlock(static_cast<size_t>(segmentStart),
+                                                                          static_cast<size_t>(segmentEnd - segmentStart)));
+        
+        segmentStart = segmentEnd;
+    }
+    
+    if (numEvents > 0)
+    {
+        parameterEvents.clear();
+        updateLimiterMode();
+    }
+    
+    // Apply output limiting to ensure signal never exceeds -0.1dB
+    juce::dsp::ProcessContextReplacing<SampleType> context(block);
+    core.outputLimiter.process(context);
+    
+    // Once the input has been silent for long enough for everything to ring out, and the
+    // output has died away, flush all the state and sleep until the input comes back
+    silentInputSamples = inputSilent ? silentInputSamples + numSamples : 0;
+    
+    updateTailLength();
+    
+    if (inputSilent && silentInputSamples >= getSleepDelaySamples() && isSilent(buffer, totalNumInputChannels))
+        goToSleep<SampleType>();
+    
+    if (feedAnalyser)
+        analyserOutputFifo.push(buffer, totalNumInputChannels);
+    
+    performanceCounters.endBlock(blockStartTicks, buffer.getNumSamples(), parametersSmoothing,
+                                 core.outputLimiter.getReducedSamples(),
+                                 static_cast<float>(core.outputLimiter.getMaxGainReductionDb()));
+}
+
+template <typename SampleType>
+bool NewPluginSkeletonAudioProcessor::isSilent (const juce::AudioBuffer<SampleType>& buffer, int numChannels)
+{
+    for (int ch = 0; ch < juce::jmin(numChannels, buffer.getNumChannels()); ++ch)
+        if (buffer.getMagnitude(ch, 0, buffer.getNumSamples()) >= static_cast<SampleType>(silenceThreshold))
+            return false;
+    
+    return true;
+}
+
+void NewPluginSkeletonAudioProcessor::updateTailLength()
+{
+    // The longest ring-down of the two layouts, in case a slope crossfade is running, and
+    // the filter sets
+    double tail = 0.0;
+    
+    for (int set = 0; set < numFilterSets; ++set)
+    {
+        const auto cutoff = cutoffSmoothers[static_cast<size_t>(set)].getTargetValue();
+        const auto res = resonanceSmoothers[static_cast<size_t>(set)].getTargetValue();
+        
+        tail = juce::jmax(tail,
+                          FilterDesign::getDecayTimeSeconds(*activeLayout, cutoff, res, tailDecibels),
+                          FilterDesign::getDecayTimeSeconds(*outgoingLayout, cutoff, res, tailDecibels));
+    }
+    
+    tailLengthSeconds.store(tail, std::memory_order_relaxed);
+}
+
+juce::int64 NewPluginSkeletonAudioProcessor::getSleepDelaySamples() const
+{
+    // The filters' tail plus whatever the oversamplers and limiter are still holding back
+    return static_cast<juce::int64>(std::ceil(getTailLengthSeconds() * currentSampleRate)) + getLatencySamples();
+}
+
+template <typename SampleType>
+void NewPluginSkeletonAudioProcessor::goToSleep()
+{
+    // Everything starts again from silence when the input comes back, which is where
+    // it would have decayed to anyway; nothing is left to turn into denormals meanwhile
+    auto& core = getCore<SampleType>();
+    core.filterChain.reset();
+    core.shadowFilterChain.reset();
+    core.outgoingRateFilterChain.reset();
+    core.filterOversampling.reset();
+    core.outputLimiter.reset();
     
+    settleParameters();
+    sleeping.store(true, std::memory_order_relaxed);
+}
+
+void NewPluginSkeletonAudioProcessor::settleParameters()
+{
+    for (int set = 0; set < numFilterSets; ++set)
+    {
+        cutoffSmoothers[static_cast<size_t>(set)].setCurrentAndTargetValue(cutoffSmoothers[static_cast<size_t>(set)].getTargetValue());
+        resonanceSmoothers[static_cast<size_t>(set)].setCurrentAndTargetValue(resonanceSmoothers[static_cast<size_t>(set)].getTargetValue());
+        gainSmoothers[static_cast<size_t>(set)].setCurrentAndTargetValue(gainSmoothers[static_cast<size_t>(set)].getTargetValue());
+    }
+    
+    // With the filter state flushed the slope, type and oversampling can switch without a crossfade
+    slopeSmoother.setCurrentAndTargetValue(1.0f);
+    oversamplingCrossfade.setCurrentAndTargetValue(1.0f);
+    activeBandpass = blockParameters.filterTypeIndex == 2;
+    activeDesignIndex = outgoingDesignIndex = getDesignIndex(blockParameters.slopeIndex, blockParameters.alignmentIndex);
+    activeLayout = outgoingLayout = &getDesignLayout(activeDesignIndex, activeBandpass);
+    sharedSlopeStages = 0;
+}
+
+template <typename SampleType>
+void NewPluginSkeletonAudioProcessor::beginSlopeTransition (int newDesignIndex)
+{
+    auto& core = getCore<SampleType>();
+    
+    // The shadow chain picks up exactly where the current slope left off and keeps
+    // running it while the new slope fades in. If a transition is already running,
+    // the slope that was fading in becomes the outgoing one.
+    core.shadowFilterChain.copyStateFrom(core.filterChain);
+    outgoingDesignIndex = activeDesignIndex;
+    outgoingLayout = activeLayout;
+    activeDesignIndex = newDesignIndex;
+    activeLayout = &getDesignLayout(activeDesignIndex, activeBandpass);
+    
+    // Sections that differ from the outgoing ones (kind, Q or just not running before)
+    // start from silence while they fade in
+    sharedSlopeStages = FilterDesign::getSharedSections(*outgoingLayout, *activeLayout);
+    core.filterChain.resetStages(sharedSlopeStages);
+    core.outgoingRateFilterChain.resetStages(sharedSlopeStages);  // Follows the active slope
+    
+    slopeSmoother.setCurrentAndTargetValue(0.0f);
+    slopeSmoother.setTargetValue(1.0f);
+}
+
+template <typename SampleType>
+void NewPluginSkeletonAudioProcessor::setBandpassLayouts (bool bandpass)
+{
+    auto& core = getCore<SampleType>();
+    
+    // Switching the filter type is instant, as it always was, but bandpass runs other
+    // sections than lowpass and highpass: the ones that change start from silence
+    activeBandpass = bandpass;
+    
+    const auto& newActiveLayout = getDesignLayout(activeDesignIndex, bandpass);
+    const auto& newOutgoingLayout = getDesignLayout(outgoingDesignIndex, bandpass);
+    
+    core.filterChain.resetStages(FilterDesign::getSharedSections(*activeLayout, newActiveLayout));
+    core.shadowFilterChain.resetStages(FilterDesign::getSharedSections(*outgoingLayout, newOutgoingLayout));
+    core.outgoingRateFilterChain.resetStages(FilterDesign::getSharedSections(*activeLayout, newActiveLayout));
+    
+    activeLayout = &newActiveLayout;
+    outgoingLayout = &newOutgoingLayout;
+    sharedSlopeStages = FilterDesign::getSharedSections(*outgoingLayout, *activeLayout);
+}
+
+void NewPluginSkeletonAudioProcessor::assignFilterSets (int newStereoMode)
+{
+    // Only the second channel (right, or side) ever runs set 1. The engines never move,
+    // so the pointers stay valid; the chains pack them into their lanes every block.
+    activeStereoMode = newStereoMode;
+    
+    withActiveCore([newStereoMode](auto& core)
+    {
+        for (int ch = 0; ch < maxSupportedChannels; ++ch)
+        {
+            const auto set = static_cast<size_t>(ch == 1 && newStereoMode != linkedStereo ? 1 : 0);
+            core.channelCoefficients[static_cast<size_t>(ch)] = core.coefficientEngines[set].getCoefficients();
+            core.shadowChannelCoefficients[static_cast<size_t>(ch)] = core.shadowCoefficientEngines[set].getCoefficients();
+            core.outgoingRateChannelCoefficients[static_cast<size_t>(ch)] = core.outgoingRateCoefficientEngines[set].getCoefficients();
+        }
+    });
+}
+
+void NewPluginSkeletonAudioProcessor::setFilterSetTargets()
+{
+    const bool linked = blockParameters.stereoModeIndex == linkedStereo;
+    
+    cutoffSmoothers[0].setTargetValue(blockParameters.cutoff);
+    resonanceSmoothers[0].setTargetValue(blockParameters.resonance);
+    cutoffSmoothers[1].setTargetValue(linked ? blockParameters.cutoff : blockParameters.cutoff2);
+    resonanceSmoothers[1].setTargetValue(linked ? blockParameters.resonance : blockParameters.resonance2);
+    gainSmoothers[0].setTargetValue(blockParameters.gain);
+    gainSmoothers[1].setTargetValue(linked ? blockParameters.gain : blockParameters.gain2);
+}
+
+bool NewPluginSkeletonAudioProcessor::isFilterSetSmoothing() const noexcept
+{
+    for (int set = 0; set < numFilterSets; ++set)
+        if (cutoffSmoothers[static_cast<size_t>(set)].isSmoothing() || resonanceSmoothers[static_cast<size_t>(set)].isSmoothing())
+            return true;
+    
+    return false;
+}
+
+template <typename SampleType>
+bool NewPluginSkeletonAudioProcessor::processSegment (const juce::dsp::AudioBlock<SampleType>& block)
+{
     // Map filter type index to StateVariableTPTFilterType
     juce::dsp::StateVariableTPTFilterType filterMode;
-    switch (filterTypeIndex)
+    switch (blockParameters.filterTypeIndex)
     {
         case 0: filterMode = juce::dsp::StateVariableTPTFilterType::lowpass; break;   // Low-pass
         case 1: filterMode = juce::dsp::StateVariableTPTFilterType::highpass; break;  // High-pass
@@ -201,102 +613,448 @@ void NewPluginSkeletonAudioProcessor::processBlock (juce::AudioBuffer<float>& bu
         default: filterMode = juce::dsp::StateVariableTPTFilterType::lowpass; break;
     }
     
-    auto numSamples = buffer.getNumSamples();
+    const bool bandpass = filterMode == juce::dsp::StateVariableTPTFilterType::bandpass;
+    if (bandpass != activeBandpass)
+        setBandpassLayouts<SampleType>(bandpass);
+    
+    const int designIndex = getDesignIndex(blockParameters.slopeIndex, blockParameters.alignmentIndex);
+    if (designIndex != activeDesignIndex)
+        beginSlopeTransition<SampleType>(designIndex);
+    
+    // Switching the stereo mode is instant too
+    if (blockParameters.stereoModeIndex != activeStereoMode)
+        assignFilterSets(blockParameters.stereoModeIndex);
+    
+    // Steady state runs the whole segment through the SIMD cascade; sub-block processing
+    // is only needed while cutoff, resonance or slope are smoothing
+    const bool filterSmoothing = isFilterSetSmoothing() || slopeSmoother.isSmoothing();
+    const bool parametersSmoothing = filterSmoothing || gainSmoothers[0].isSmoothing() || gainSmoothers[1].isSmoothing();
+    
+    // Mid/side filters the sum and difference of the first two channels in their place
+    const bool midSide = activeStereoMode == midSideStereo && block.getNumChannels() >= 2;
+    if (midSide)
+        convertMidSide(block, true);
     
-    // Update filter parameters for each sample (sample-accurate automation)
-    for (int sample = 0; sample < numSamples; ++sample)
+    // The oversamplers are sized for the block size given to prepareToPlay
+    const int numSamples = static_cast<int>(block.getNumSamples());
+    for (int start = 0; start < numSamples; start += maxOversamplingBlockSize)
     {
-        float currentCutoff = cutoffSmoother.getNextValue();
-        float currentResonance = resonanceSmoother.getNextValue();
-        float currentGainDB = gainSmoother.getNextValue();
-        float currentSlopeSmooth = slopeSmoother.getNextValue();
+        const int length = juce::jmin(maxOversamplingBlockSize, numSamples - start);
+        processFilter(block.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(length)),
+                      filterMode, filterSmoothing);
+    }
+    
+    // Each set's gain goes on its own channel, so in mid/side on the side before decoding
+    applyOutputGain(block);
+    
+    if (midSide)
+        convertMidSide(block, false);
+    
+    return parametersSmoothing;
+}
+
+template <typename SampleType>
+void NewPluginSkeletonAudioProcessor::processFilter (const juce::dsp::AudioBlock<SampleType>& block,
+                                                     juce::dsp::StateVariableTPTFilterType filterMode,
+                                                     bool filterSmoothing)
+{
+    auto& core = getCore<SampleType>();
+    const int oversamplingFactor = 1 << activeOversamplingIndex;
+    const auto numSamples = block.getNumSamples();
+    auto filterBlock = block;
+    
+    // While a factor switch crossfades, the outgoing path filters a copy of the input
+    // at its own rate, with the settings as they stand at the start of this stretch
+    const bool crossfading = oversamplingCrossfade.isSmoothing();
+    const bool outgoingSeparate = crossfading && isOutgoingOversamplingSeparate();
+    auto outgoingBlock = juce::dsp::AudioBlock<SampleType>(core.outgoingRateBuffer)
+                             .getSubsetChannelBlock(0, block.getNumChannels()).getSubBlock(0, numSamples);
+    
+    if (outgoingSeparate)
+    {
+        outgoingBlock.copyFrom(block);
+        
+        for (int set = 0; set < (activeStereoMode == linkedStereo ? 1 : numFilterSets); ++set)
+            core.outgoingRateCoefficientEngines[static_cast<size_t>(set)].update(cutoffSmoothers[static_cast<size_t>(set)].getCurrentValue(),
+                                                                             resonanceSmoothers[static_cast<size_t>(set)].getCurrentValue(),
+                                                                             *activeLayout);
         
-        // Convert gain from dB to linear
-        float gainLinear = juce::Decibels::decibelsToGain(currentGainDB);
+        auto outgoingFilterBlock = outgoingBlock;
+        if (outgoingOversamplingIndex > 0)
+            outgoingFilterBlock = core.filterOversampling.processUp(outgoingBlock, outgoingOversamplingIndex, outgoingOversamplingDesign);
         
-        // Get integer slope indices for crossfading
-        int currentSlopeIndex = static_cast<int>(std::round(currentSlopeSmooth));
-        int prevSlopeIndex = currentSlopeIndex;
-        float crossfadeAmount = 0.0f;
+        core.outgoingRateFilterChain.process(outgoingFilterBlock, *activeLayout, core.outgoingRateChannelCoefficients.data(), filterMode);
         
-        // Calculate crossfade if we're between slopes
-        if (currentSlopeSmooth != static_cast<float>(currentSlopeIndex))
+        if (outgoingOversamplingIndex > 0)
+            core.filterOversampling.processDown(outgoingBlock, outgoingOversamplingIndex, outgoingOversamplingDesign);
+    }
+    
+    if (activeOversamplingIndex > 0)
+        filterBlock = core.filterOversampling.processUp(block, activeOversamplingIndex, activeOversamplingDesign);
+    
+    if (filterSmoothing)
+        processSmoothingBlock(filterBlock, filterMode, oversamplingFactor);
+    else
+        processSettledBlock(filterBlock, filterMode);
+    
+    if (activeOversamplingIndex > 0)
+        core.filterOversampling.processDown(block, activeOversamplingIndex, activeOversamplingDesign);
+    
+    // Only the padding changed: the same filtered signal, on the old delay line
+    if (crossfading && ! outgoingSeparate)
+        outgoingBlock.copyFrom(block);
+    
+    core.filterOversampling.processDelay(block, oversamplingPadding, oversamplingDelayLine);
+    
+    if (! crossfading)
+        return;
+    
+    core.filterOversampling.processDelay(outgoingBlock, outgoingOversamplingPadding, 1 - oversamplingDelayLine);
+    
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        const auto fade = static_cast<SampleType>(oversamplingCrossfade.getNextValue());
+        
+        for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
         {
-            prevSlopeIndex = static_cast<int>(std::floor(currentSlopeSmooth));
-            int nextSlopeIndex = static_cast<int>(std::ceil(currentSlopeSmooth));
-            if (prevSlopeIndex != nextSlopeIndex)
-            {
-                crossfadeAmount = currentSlopeSmooth - static_cast<float>(prevSlopeIndex);
-                currentSlopeIndex = nextSlopeIndex;
-            }
+            auto* incoming = block.getChannelPointer(ch);
+            const auto* outgoing = outgoingBlock.getChannelPointer(ch);
+            incoming[i] = outgoing[i] + fade * (incoming[i] - outgoing[i]);
         }
+    }
+}
+
+template <typename SampleType>
+void NewPluginSkeletonAudioProcessor::processSettledBlock (const juce::dsp::AudioBlock<SampleType>& block,
+                                                           juce::dsp::StateVariableTPTFilterType filterMode)
+{
+    auto& core = getCore<SampleType>();
+    
+    // Nothing is ramping, so a single set of cached coefficients per filter set covers
+    // the whole block
+    for (int set = 0; set < (activeStereoMode == linkedStereo ? 1 : numFilterSets); ++set)
+        core.coefficientEngines[static_cast<size_t>(set)].update(cutoffSmoothers[static_cast<size_t>(set)].getTargetValue(),
+                                                                 resonanceSmoothers[static_cast<size_t>(set)].getTargetValue(),
+                                                                 *activeLayout);
+    
+    core.filterChain.process(block, *activeLayout, core.channelCoefficients.data(), filterMode);
+}
+
+template <typename SampleType>
+void NewPluginSkeletonAudioProcessor::processSmoothingBlock (const juce::dsp::AudioBlock<SampleType>& block,
+                                                             juce::dsp::StateVariableTPTFilterType filterMode,
+                                                             int oversamplingFactor)
+{
+    auto& core = getCore<SampleType>();
+    constexpr int updateInterval = decltype(core.coefficientEngines)::value_type::updateInterval;
+    const int numSamples = static_cast<int>(block.getNumSamples());
+    const int activeStages = activeLayout->numSections;
+    const int outgoingStages = outgoingLayout->numSections;
+    const int setsInUse = activeStereoMode == linkedStereo ? 1 : numFilterSets;
+    
+    // Filter coefficients only need refreshing while cutoff or resonance are ramping,
+    // and the slope crossfade is computed on the same grid. The smoothers run at the
+    // host rate, so when oversampled a sub-block spans updateInterval host samples.
+    const bool coefficientsSmoothing = isFilterSetSmoothing();
+    const int coefficientInterval = (coefficientsSmoothing || slopeSmoother.isSmoothing())
+                                  ? updateInterval * oversamplingFactor : numSamples;
+    
+    for (int subBlockStart = 0; subBlockStart < numSamples; subBlockStart += coefficientInterval)
+    {
+        const int subBlockLength = juce::jmin(coefficientInterval, numSamples - subBlockStart);
+        const int hostSamples = subBlockLength / oversamplingFactor;
+        auto subBlock = block.getSubBlock(static_cast<size_t>(subBlockStart), static_cast<size_t>(subBlockLength));
         
-        // Update all filters with current parameters
-        // For proper Butterworth response, distribute Q across stages
-        int numStages = getSlopeFilterStages(currentSlopeIndex);
-        float stageResonance = currentResonance;
-        
-        // For cascaded filters, adjust Q per stage for proper Butterworth response
-        if (numStages > 1)
+        // Advance the coefficient smoothers once per sub-block, including those of a
+        // filter set that isn't in use, so it keeps following while linked
+        std::array<float, numFilterSets> currentCutoff, currentResonance;
+        for (size_t set = 0; set < static_cast<size_t>(numFilterSets); ++set)
         {
-            // Butterworth Q values: 2-pole = 0.707, 4-pole cascaded = 0.54 and 1.31
-            if (numStages == 2)
-                stageResonance = currentResonance * 0.707f / 0.707f; // Normalized
-            else if (numStages == 4)
-                stageResonance = currentResonance * 0.54f / 0.707f; // Use lower Q for stability
+            currentCutoff[set] = cutoffSmoothers[set].getNextValue();
+            currentResonance[set] = resonanceSmoothers[set].getNextValue();
+            cutoffSmoothers[set].skip(hostSamples - 1);
+            resonanceSmoothers[set].skip(hostSamples - 1);
         }
         
-        for (int stage = 0; stage < maxFilterStages; ++stage)
+        // Only recomputes anything if the cutoff or resonance actually changed
+        for (size_t set = 0; set < static_cast<size_t>(setsInUse); ++set)
+            core.coefficientEngines[set].update(currentCutoff[set], currentResonance[set], *activeLayout);
+        
+        if (! slopeSmoother.isSmoothing())
         {
-            filterChain[stage].setCutoffFrequency(currentCutoff);
-            filterChain[stage].setResonance(stageResonance);
-            filterChain[stage].setType(filterMode);
+            core.filterChain.process(subBlock, *activeLayout, core.channelCoefficients.data(), filterMode);
+            continue;
         }
         
-        // Process each channel through the cascaded filter chain
-        for (int ch = 0; ch < totalNumInputChannels; ++ch)
+        // Slope transition: fade from the shadow chain's outgoing slope to the new one
+        for (size_t set = 0; set < static_cast<size_t>(setsInUse); ++set)
+            core.shadowCoefficientEngines[set].update(currentCutoff[set], currentResonance[set], *outgoingLayout);
+        
+        std::array<SampleType, updateInterval * FilterOversampling<float>::maxFactor> fadeIn;
+        for (int sample = 0; sample < hostSamples; ++sample)
         {
-            float inputSample = buffer.getSample(ch, sample);
-            float outputSample = inputSample;
+            const auto fade = static_cast<SampleType>(slopeSmoother.getNextValue());
             
-            // Process through active filter stages
-            int activeStages = getSlopeFilterStages(currentSlopeIndex);
-            for (int stage = 0; stage < activeStages; ++stage)
-            {
-                outputSample = filterChain[stage].processSample(ch, outputSample);
-            }
-            
-            // If crossfading, also process through previous slope configuration
-            if (crossfadeAmount > 0.0f && prevSlopeIndex != currentSlopeIndex)
-            {
-                float prevOutputSample = inputSample;
-                int prevStages = getSlopeFilterStages(prevSlopeIndex);
-                for (int stage = 0; stage < prevStages; ++stage)
-                {
-                    prevOutputSample = filterChain[stage].processSample(ch, prevOutputSample);
-                }
-                // Crossfade between the two slope outputs
-                outputSample = prevOutputSample * (1.0f - crossfadeAmount) + outputSample * crossfadeAmount;
-            }
-            
-            // Apply post-filter gain
-            outputSample *= gainLinear;
+            for (int k = 0; k < oversamplingFactor; ++k)
+                fadeIn[static_cast<size_t>(sample * oversamplingFactor + k)] = fade;
+        }
+        
+        core.filterChain.processCrossfade(subBlock, activeStages, core.channelCoefficients.data(),
+                                          core.shadowFilterChain, outgoingStages, core.shadowChannelCoefficients.data(),
+                                          sharedSlopeStages, filterMode, fadeIn.data());
+    }
+}
+
+template <typename SampleType>
+void NewPluginSkeletonAudioProcessor::convertMidSide (const juce::dsp::AudioBlock<SampleType>& block, bool encode) noexcept
+{
+    // M = (L + R) / 2, S = (L - R) / 2 and back with L = M + S, R = M - S
+    const auto scale = encode ? static_cast<SampleType>(0.5) : static_cast<SampleType>(1);
+    auto* first = block.getChannelPointer(0);
+    auto* second = block.getChannelPointer(1);
+    
+    for (size_t i = 0; i < block.getNumSamples(); ++i)
+    {
+        const auto a = first[i], b = second[i];
+        first[i] = (a + b) * scale;
+        second[i] = (a - b) * scale;
+    }
+}
+
+template <typename SampleType>
+void NewPluginSkeletonAudioProcessor::applyOutputGain (const juce::dsp::AudioBlock<SampleType>& block)
+{
+    // Channel 1 takes set 1's gain, like its filter; while linked that follows set 0
+    const int numSamples = static_cast<int>(block.getNumSamples());
+    const auto getSet = [](size_t ch) { return ch == 1 ? 1 : 0; };
+    
+    if (gainSmoothers[0].isSmoothing() || gainSmoothers[1].isSmoothing())
+    {
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            const float gainLinear[] = { juce::Decibels::decibelsToGain(gainSmoothers[0].getNextValue()),
+                                         juce::Decibels::decibelsToGain(gainSmoothers[1].getNextValue()) };
             
-            buffer.setSample(ch, sample, outputSample);
+            for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+                block.getChannelPointer(ch)[sample] *= gainLinear[getSet(ch)];
         }
     }
+    else
+    {
+        const float gainLinear[] = { juce::Decibels::decibelsToGain(gainSmoothers[0].getTargetValue()),
+                                     juce::Decibels::decibelsToGain(gainSmoothers[1].getTargetValue()) };
+        
+        if (gainLinear[0] == gainLinear[1])
+        {
+            if (gainLinear[0] != 1.0f)
+                block.multiplyBy(gainLinear[0]);
+        }
+        else
+        {
+            for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+                block.getSingleChannelBlock(ch).multiplyBy(gainLinear[getSet(ch)]);
+        }
+    }
+}
+
+void NewPluginSkeletonAudioProcessor::updateLimiterMode()
+{
+    // Only changes anything when the settings did; the limiter is preallocated for
+    // the longest lookahead so this never allocates
+    bool modeChanged = false;
+    withActiveCore([&](auto& core) { modeChanged = core.outputLimiter.setMode(blockParameters.truePeak, blockParameters.lookaheadMs); });
     
-    // Apply output limiting to ensure signal never exceeds -0.1dB
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    outputLimiter.process(context);
+    if (modeChanged)
+        updateLatency();
+}
+
+bool NewPluginSkeletonAudioProcessor::updateBlockParameters (bool force)
+{
+    // A rebuilt morph table counts as a change too
+    const bool morphChanged = morphEngine.update();
+    
+    if (! force && ! morphChanged && parameterSnapshot.getVersion() == blockParametersVersion)
+        return false;
+    
+    // A read that overlaps a state load being published keeps the previous block's
+    // values (the version has moved, so the next block tries again)
+    const auto previous = blockValues;
+    
+    if (! parameterSnapshot.read(blockValues))
+    {
+        if (! force && ! morphChanged)
+            return false;
+    }
+    else
+    {
+        blockParametersVersion = blockValues.version;
+        
+        // The host has already set automated parameters to their value at the end of the
+        // block; they start from where they were and the events move them
+        if (! force)
+            for (const auto& event : parameterEvents)
+                if (juce::isPositiveAndBelow(event.parameterIndex, ParameterSnapshot::maxParameters))
+                    blockValues.raw[static_cast<size_t>(event.parameterIndex)] = previous.raw[static_cast<size_t>(event.parameterIndex)];
+    }
+    
+    applyBlockValues();
+    return true;
+}
+
+void NewPluginSkeletonAudioProcessor::applyBlockValues()
+{
+    const auto& values = blockValues;
+    auto& p = blockParameters;
+    p.cutoff = values.get(cutoffFreq, p.cutoff);
+    p.resonance = values.get(resonance, p.resonance);
+    p.gain = values.get(gain, p.gain);
+    p.lookaheadMs = values.get(lookahead, p.lookaheadMs);
+    p.slopeIndex = juce::roundToInt(values.get(filterSlope, static_cast<float>(p.slopeIndex)));
+    p.filterTypeIndex = juce::roundToInt(values.get(filterType, static_cast<float>(p.filterTypeIndex)));
+    p.oversamplingChoice = juce::roundToInt(values.get(oversampling, static_cast<float>(p.oversamplingChoice)));
+    p.oversamplingFilterIndex = juce::roundToInt(values.get(oversamplingFilter, static_cast<float>(p.oversamplingFilterIndex)));
+    p.alignmentIndex = juce::roundToInt(values.get(filterAlignment, static_cast<float>(p.alignmentIndex)));
+    p.truePeak = values.get(truePeak, p.truePeak ? 1.0f : 0.0f) >= 0.5f;
+    p.morphX = values.get(morphX, p.morphX);
+    p.morphY = values.get(morphY, p.morphY);
+    p.stereoModeIndex = juce::roundToInt(values.get(stereoMode, static_cast<float>(p.stereoModeIndex)));
+    p.cutoff2 = values.get(cutoffFreq2, p.cutoff2);
+    p.resonance2 = values.get(resonance2, p.resonance2);
+    p.gain2 = values.get(gain2, p.gain2);
+    
+    // With morph snapshots loaded, the filter settings come from the precomputed table
+    if (morphEngine.isActive())
+    {
+        std::array<float, MorphEngine::maxTargets> morphed;
+        morphEngine.getValues(p.morphX, p.morphY, morphed.data());
+        applyMorphedValues(morphed, p);
+    }
+}
+
+void NewPluginSkeletonAudioProcessor::applyParameterEvent (const ParameterEventQueue::Event& event)
+{
+    if (! juce::isPositiveAndBelow(event.parameterIndex, ParameterSnapshot::maxParameters))
+        return;
+    
+    blockValues.raw[static_cast<size_t>(event.parameterIndex)] = event.value;
+    applyBlockValues();
+    
+    // Smoothers start ramping from exactly this sample; slope, type and stereo mode are
+    // picked up by the next segment, limiter settings once the block's events are done
+    setFilterSetTargets();
+}
+
+int NewPluginSkeletonAudioProcessor::getWantedOversamplingIndex() const
+{
+    const int choice = blockParameters.oversamplingChoice;
+    
+    if (choice != autoOversamplingChoice)
+        return choice;
+    
+    // Auto: the smallest factor that keeps the highest cutoff below a fraction of the
+    // (oversampled) Nyquist frequency, so low cutoffs cost nothing extra
+    const double nyquist = currentSampleRate * 0.5;
+    float cutoff = 0.0f;
+    for (const auto& smoother : cutoffSmoothers)
+        cutoff = juce::jmax(cutoff, smoother.getTargetValue());
+    
+    int wanted = 0;
+    while (wanted < autoMaxOversamplingIndex && cutoff > autoOversamplingThreshold * nyquist * (1 << wanted))
+        ++wanted;
+    
+    // Hysteresis: only step down once the cutoff is clearly below the lower factor's limit,
+    // so a cutoff hovering around a threshold doesn't keep switching
+    if (activeOversamplingAuto && wanted < activeOversamplingIndex
+        && cutoff > 0.8f * autoOversamplingThreshold * nyquist * (1 << (activeOversamplingIndex - 1)))
+        wanted = activeOversamplingIndex;
+    
+    return wanted;
+}
+
+void NewPluginSkeletonAudioProcessor::applyOversamplingSettings (int factorIndex, OversamplingDesign design, bool isAuto)
+{
+    const bool factorChanged = factorIndex != activeOversamplingIndex || design != activeOversamplingDesign;
+    
+    activeOversamplingIndex = factorIndex;
+    activeOversamplingDesign = design;
+    activeOversamplingAuto = isAuto;
+    
+    // Coefficients are computed for the rate the filter chain actually runs at. The
+    // filter state carries over: it's roughly rate-independent, like a coefficient change.
+    const double filterRate = currentSampleRate * (1 << factorIndex);
+    
+    withActiveCore([&](auto& core)
+    {
+        // The oversampler being switched to holds stale state from its last use
+        if (factorChanged)
+            core.filterOversampling.resetFactor(factorIndex, design);
+        
+        core.filterOversampling.resetDelay(oversamplingDelayLine);
+        for (auto& engine : core.coefficientEngines)
+            engine.prepare(filterRate);
+        
+        for (auto& engine : core.shadowCoefficientEngines)
+            engine.prepare(filterRate);
+    });
+    
+    filterSampleRate.store(filterRate, std::memory_order_relaxed);
+    
+    updateLatency();
+}
+
+template <typename SampleType>
+void NewPluginSkeletonAudioProcessor::beginOversamplingSwitch (int factorIndex, OversamplingDesign design, bool isAuto)
+{
+    auto& core = getCore<SampleType>();
+    
+    // The outgoing path carries on exactly where the active one is: same oversampler,
+    // filter state and coefficients at its rate, and padding on its own delay line.
+    // The new path's padding starts on the other line.
+    outgoingOversamplingIndex = activeOversamplingIndex;
+    outgoingOversamplingDesign = activeOversamplingDesign;
+    outgoingOversamplingPadding = oversamplingPadding;
+    
+    core.outgoingRateFilterChain.copyStateFrom(core.filterChain);
+    for (auto& engine : core.outgoingRateCoefficientEngines)
+        engine.prepare(getFilterSampleRate());
+    
+    oversamplingDelayLine = 1 - oversamplingDelayLine;
+    applyOversamplingSettings(factorIndex, design, isAuto);
+    
+    oversamplingCrossfade.setCurrentAndTargetValue(0.0f);
+    oversamplingCrossfade.setTargetValue(1.0f);
+}
+
+bool NewPluginSkeletonAudioProcessor::isOutgoingOversamplingSeparate() const noexcept
+{
+    // At 1x both designs are the bare filter chain
+    if (outgoingOversamplingIndex == 0 && activeOversamplingIndex == 0)
+        return false;
+    
+    return outgoingOversamplingIndex != activeOversamplingIndex || outgoingOversamplingDesign != activeOversamplingDesign;
+}
+
+void NewPluginSkeletonAudioProcessor::updateLatency()
+{
+    // Auto mode always reports the latency of its highest factor and pads lower
+    // factors up to it, so the host's delay compensation doesn't change under it
+    withActiveCore([this](auto& core)
+    {
+        const int activeLatency = core.filterOversampling.getLatencySamples(activeOversamplingIndex, activeOversamplingDesign);
+        const int reportedLatency = activeOversamplingAuto
+            ? juce::jmax(activeLatency, core.filterOversampling.getLatencySamples(autoMaxOversamplingIndex, activeOversamplingDesign))
+            : activeLatency;
+        
+        oversamplingPadding = reportedLatency - activeLatency;
+        setLatencySamples(reportedLatency + core.outputLimiter.getLatencySamples());
+    });
 }
 
 //==============================================================================
 bool NewPluginSkeletonAudioProcessor::hasEditor() const
 {
-#if JUCE_UNIT_TESTS
-    return false; // No editor for unit tests
+#if JUCE_UNIT_TESTS || FRANKYS_FILTERS_HEADLESS
+    return false; // No editor for unit tests or the offline renderer
 #else
     return true;
 #endif
@@ -304,8 +1062,8 @@ bool NewPluginSkeletonAudioProcessor::hasEditor() const
 
 juce::AudioProcessorEditor* NewPluginSkeletonAudioProcessor::createEditor()
 {
-#if JUCE_UNIT_TESTS
-    return nullptr;  // No editor for unit tests
+#if JUCE_UNIT_TESTS || FRANKYS_FILTERS_HEADLESS
+    return nullptr;  // No editor for unit tests or the offline renderer
 #else
     return new NewPluginSkeletonAudioProcessorEditor (*this);
 #endif
@@ -314,17 +1072,134 @@ juce::AudioProcessorEditor* NewPluginSkeletonAudioProcessor::createEditor()
 //==============================================================================
 void NewPluginSkeletonAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    auto state = parameters.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Compact binary state; see BinaryStateFormat
+    stateFormat.write(destData);
+    appendMorphSnapshots(destData);
+}
+
+void NewPluginSkeletonAudioProcessor::appendMorphSnapshots (juce::MemoryBlock& state) const
+{
+    // Without the morph nothing is appended, so saving the usual session doesn't
+    // allocate beyond the host's block (see BinaryStateFormat)
+    bool anySnapshot = false;
+    
+    for (int slot = 0; slot < MorphEngine::numSlots; ++slot)
+        anySnapshot = anySnapshot || morphEngine.hasSnapshot(slot);
+    
+    if (! anySnapshot)
+        return;
+    
+    // Per filled slot: its index, the number of values, then each parameter ID and raw value
+    juce::MemoryOutputStream chunk;
+    
+    for (int slot = 0; slot < MorphEngine::numSlots; ++slot)
+    {
+        if (! morphEngine.hasSnapshot(slot))
+            continue;
+        
+        const auto values = morphEngine.getSnapshot(slot);
+        
+        chunk.writeByte(static_cast<char>(slot));
+        chunk.writeCompressedInt(values.size());
+        
+        for (const auto& value : values)
+        {
+            chunk.writeString(value.name.toString());
+            chunk.writeFloat(static_cast<float>(value.value));
+        }
+    }
+    
+    if (chunk.getDataSize() > 0)
+        BinaryStateFormat::appendChunk(state, morphChunkID, chunk.getData(), chunk.getDataSize());
+}
+
+void NewPluginSkeletonAudioProcessor::restoreMorphSnapshots (const juce::MemoryBlock& chunk)
+{
+    // A session without the chunk had no morph, so loading it turns the morph off
+    morphEngine.clearSnapshots();
+    juce::MemoryInputStream in(chunk, false);
+    
+    while (! in.isExhausted())
+    {
+        const int slot = in.readByte();
+        const int numValues = in.readCompressedInt();
+        juce::NamedValueSet values;
+        
+        for (int i = 0; i < numValues && ! in.isExhausted(); ++i)
+        {
+            // Before version 3 the slope target was saved as "slope"
+            const auto parameterID = in.readString();
+            values.set(parameterID == "slope" ? juce::String("filterSlope") : parameterID, in.readFloat());
+        }
+        
+        if (juce::isPositiveAndBelow(slot, MorphEngine::numSlots) && ! values.isEmpty())
+            morphEngine.setSnapshot(slot, values);
+    }
+}
+
+void NewPluginSkeletonAudioProcessor::setParameterValues (const juce::NamedValueSet& rawValues)
+{
+    const ParameterSnapshot::ScopedBatch batch(parameterSnapshot);
+    const ScopedStateLoad stateLoad(loadingState);
+    
+    for (const auto& value : rawValues)
+        if (auto* parameter = parameters.getParameter(value.name.toString()))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(static_cast<float>(value.value)));
 }
 
 void NewPluginSkeletonAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
+    // The audio thread sees the whole new state at once, never half of it
+    const ParameterSnapshot::ScopedBatch batch(parameterSnapshot);
+    const ScopedStateLoad stateLoad(loadingState);
+    
+    if (BinaryStateFormat::isBinaryState(data, sizeInBytes))
+    {
+        if (stateFormat.read(data, sizeInBytes))
+            restoreMorphSnapshots(BinaryStateFormat::findChunk(data, sizeInBytes, morphChunkID));
+        
+        return;
+    }
+    
+    // Sessions saved before the binary format hold the parameter tree as XML
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
     if (xmlState.get() != nullptr)
+    {
         if (xmlState->hasTagName(parameters.state.getType()))
-            parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
+        {
+            loadXmlState(*xmlState);
+            restoreMorphSnapshots({});  // These sessions predate the morph
+        }
+    }
+}
+
+void NewPluginSkeletonAudioProcessor::loadXmlState (juce::XmlElement& xml)
+{
+    const ParameterSnapshot::ScopedBatch batch(parameterSnapshot);
+    const ScopedStateLoad stateLoad(loadingState);
+    
+    upgradeXmlState(xml);
+    parameters.replaceState(juce::ValueTree::fromXml(xml));
+}
+
+void NewPluginSkeletonAudioProcessor::upgradeXmlState (juce::XmlElement& xml)
+{
+    // The XML sessions all predate the version property, i.e. they're version 1.
+    // Before version 3 the slope was only saved as "slope".
+    const int version = xml.getIntAttribute("version", 1);
+    
+    if (version < 3 && xml.getChildByAttribute("id", "filterSlope") == nullptr)
+    {
+        if (auto* legacy = xml.getChildByAttribute("id", "slope"))
+        {
+            const int slopeIndex = juce::roundToInt(legacy->getDoubleAttribute("value"));
+            auto* parameter = xml.createNewChildElement("PARAM");
+            parameter->setAttribute("id", "filterSlope");
+            parameter->setAttribute("value", version < 2 ? FilterDesign::getSlopeIndexFromVersion1(slopeIndex) : slopeIndex);
+        }
+    }
+    
+    xml.setAttribute("version", static_cast<int>(BinaryStateFormat::currentVersion));
 }
 
 //==============================================================================
@@ -334,32 +1209,99 @@ juce::AudioProcessorValueTreeState::ParameterLayout NewPluginSkeletonAudioProces
     
     // Cutoff frequency parameter (20Hz - 20kHz, logarithmic)
     layout.add(std::make_unique<juce::AudioParameterFloat>(
-        "cutoff", "Cutoff Frequency",
+        juce::ParameterID { "cutoff", 1 }, "Cutoff Frequency",
         juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.3f), 1000.0f,
         "Hz"));
     
     // Resonance parameter (0.1 - 5.0, linear)  
     layout.add(std::make_unique<juce::AudioParameterFloat>(
-        "resonance", "Resonance",
+        juce::ParameterID { "resonance", 1 }, "Resonance",
         juce::NormalisableRange<float>(0.1f, 5.0f, 0.01f), 0.707f,
         "Q"));
     
-    // Filter slope parameter (6dB, 12dB, 24dB)
-    juce::StringArray slopeChoices = {"6 dB/oct", "12 dB/oct", "24 dB/oct"};
+    // The original three slopes, kept in place for automation recorded on them and
+    // forwarded to filterSlope (below)
+    juce::StringArray legacySlopeChoices = {"6 dB/oct", "12 dB/oct", "24 dB/oct"};
     layout.add(std::make_unique<juce::AudioParameterChoice>(
-        "slope", "Filter Slope", slopeChoices, 0)); // Default to 6dB
+        juce::ParameterID { "slope", 1 }, "Filter Slope (Legacy)", legacySlopeChoices, 0)); // Default to 6dB
     
     // Filter type parameter (Low-pass, High-pass, Band-pass)
     juce::StringArray typeChoices = {"Low-pass", "High-pass", "Band-pass"};
     layout.add(std::make_unique<juce::AudioParameterChoice>(
-        "filterType", "Filter Type", typeChoices, 0)); // Default to Low-pass
+        juce::ParameterID { "filterType", 1 }, "Filter Type", typeChoices, 0)); // Default to Low-pass
     
     // Post-filter gain parameter (-24dB to +12dB)
     layout.add(std::make_unique<juce::AudioParameterFloat>(
-        "gain", "Gain",
+        juce::ParameterID { "gain", 1 }, "Gain",
+        juce::NormalisableRange<float>(-24.0f, 12.0f, 0.1f), 0.0f,
+        "dB"));
+    
+    // Output limiter: 4x oversampled true-peak detection (adds latency)
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID { "truePeak", 2 }, "True Peak Limiting", false));
+    
+    // Output limiter lookahead (0 - 5ms, reported to the host as latency)
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID { "lookahead", 2 }, "Limiter Lookahead",
+        juce::NormalisableRange<float>(0.0f, static_cast<float>(maxLookaheadMs), 0.1f), 0.0f,
+        "ms"));
+    
+    // Filter oversampling (Off, 2x, 4x, 8x, or Auto: steps up only for high cutoffs)
+    juce::StringArray oversamplingChoices = {"Off", "2x", "4x", "8x", "Auto"};
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID { "oversampling", 2 }, "Oversampling", oversamplingChoices, 0)); // Default to Off
+    
+    // Oversampling filter design (polyphase IIR: low latency, FIR: linear phase)
+    juce::StringArray oversamplingFilterChoices = {"Polyphase IIR", "Linear Phase FIR"};
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID { "oversamplingFilter", 2 }, "Oversampling Filter", oversamplingFilterChoices, 0)); // Default to IIR
+    
+    // Preset morph position: A -> B, and towards C/D on the Y axis (only used while
+    // morph snapshots are loaded)
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID { "morph", 2 }, "Morph",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f), 0.0f));
+    
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID { "morphY", 2 }, "Morph Y",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f), 0.0f));
+    
+    // Cascade alignment (Butterworth: flat passband, Linkwitz-Riley: -6dB at the cutoff,
+    // for crossovers; odd slopes are always Butterworth)
+    juce::StringArray alignmentChoices = {"Butterworth", "Linkwitz-Riley"};
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID { "alignment", 2 }, "Filter Alignment", alignmentChoices, 0)); // Default to Butterworth
+    
+    // Stereo mode (Linked: one filter for every channel, L/R: the right channel has its
+    // own cutoff and resonance, Mid/Side: the side does)
+    juce::StringArray stereoModeChoices = {"Linked", "L/R", "Mid/Side"};
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID { "stereoMode", 2 }, "Stereo Mode", stereoModeChoices, 0)); // Default to Linked
+    
+    // Cutoff and resonance of the right (or side) channel when not linked
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID { "cutoff2", 2 }, "Cutoff Frequency R/S",
+        juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.3f), 1000.0f,
+        "Hz"));
+    
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID { "resonance2", 2 }, "Resonance R/S",
+        juce::NormalisableRange<float>(0.1f, 5.0f, 0.01f), 0.707f,
+        "Q"));
+    
+    // Post-filter gain of the right (or side) channel when not linked
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID { "gain2", 2 }, "Gain R/S",
         juce::NormalisableRange<float>(-24.0f, 12.0f, 0.1f), 0.0f,
         "dB"));
     
+    // Filter slope parameter (6dB to 48dB, see FilterDesign)
+    juce::StringArray slopeChoices;
+    for (const int decibelsPerOctave : FilterDesign::slopeDecibelsPerOctave)
+        slopeChoices.add(juce::String(decibelsPerOctave) + " dB/oct");
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID { "filterSlope", 2 }, "Filter Slope", slopeChoices, 0)); // Default to 6dB
+    
     return layout;
 }
 
@@ -369,15 +1311,3 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new NewPluginSkeletonAudioProcessor();
 }
-
-//==============================================================================
-int NewPluginSkeletonAudioProcessor::getSlopeFilterStages(int slopeIndex) const
-{
-    switch (slopeIndex)
-    {
-        case 0: return 1; // 6dB/oct - 1 stage (1-pole equivalent)
-        case 1: return 2; // 12dB/oct - 2 stages (2-pole)
-        case 2: return 4; // 24dB/oct - 4 stages (4-pole)
-        default: return 1;
-    }
-}
@@ -12,12 +12,25 @@
 #include <juce_audio_utils/juce_audio_utils.h>
 #include <juce_dsp/juce_dsp.h>
 #include <array>
+#include <type_traits>
+#include "StateVariableFilter.h"
+#include "FilterDesign.h"
+#include "SIMDFilterCascade.h"
+#include "OutputLimiter.h"
+#include "PerformanceCounters.h"
+#include "FilterOversampling.h"
+#include "AnalyserFifo.h"
+#include "BinaryStateFormat.h"
+#include "ParameterSnapshot.h"
+#include "ParameterEventQueue.h"
+#include "MorphEngine.h"
 
 //==============================================================================
 /**
     MyAwesome Filter - Low-pass filter plugin with variable slope
 */
-class NewPluginSkeletonAudioProcessor  : public juce::AudioProcessor
+class NewPluginSkeletonAudioProcessor  : public juce::AudioProcessor,
+                                         private juce::AudioProcessorValueTreeState::Listener
 {
 public:
     //==============================================================================
@@ -33,6 +46,10 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    // The whole DSP path runs natively in double when the host asks for it
+    bool supportsDoublePrecisionProcessing() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -64,6 +81,74 @@ public:
     // Public access to parameters for editor
     juce::AudioProcessorValueTreeState parameters;
     
+    // Lock-free audio callback timings, readable from any thread
+    const PerformanceCounters& getPerformanceCounters() const noexcept { return performanceCounters; }
+    void resetWorstCasePerformance() noexcept { performanceCounters.resetWorstCase(); }
+    
+    // Pre- and post-filter audio for the editor's spectrum analyser. The audio thread
+    // only pushes while analyserEnabled is set, i.e. while an analyser is reading.
+    AnalyserFifo analyserInputFifo, analyserOutputFifo;
+    std::atomic<bool> analyserEnabled { false };
+    
+    // Rate the analyser fifos are filled at (the host rate), readable from any thread
+    double getAnalyserSampleRate() const noexcept { return analyserSampleRate.load(std::memory_order_relaxed); }
+    
+    // Rate the filter cascade runs at (the host rate times the oversampling factor)
+    double getFilterSampleRate() const noexcept { return filterSampleRate.load(std::memory_order_relaxed); }
+    
+    // Brings a parameter tree saved as XML (a session from before the binary format, or
+    // a preset) from an older version up to the current parameters
+    static void upgradeXmlState(juce::XmlElement& xml);
+    
+    // Upgrades and loads a parameter tree saved as XML
+    void loadXmlState(juce::XmlElement& xml);
+    
+    // Sets several parameters (raw values by parameter ID) in one go, e.g. from a preset;
+    // the audio thread sees them all change together
+    void setParameterValues(const juce::NamedValueSet& rawValues);
+    
+    // Preset morphing: parameter snapshots (raw values by ID, e.g. a preset's) in slots
+    // A-D. Once A and B are set, the Morph parameter blends from A to B (and Morph Y
+    // towards C and D) and drives cutoff, resonance, gain, slope and filter type in place
+    // of their own parameters, along with alignment and the second filter set's cutoff and
+    // resonance. Message thread; the audio thread only does table lookups. The snapshots
+    // are saved with the session.
+    void setMorphSnapshot(int slot, const juce::NamedValueSet& rawValues) { morphEngine.setSnapshot(slot, rawValues); }
+    void clearMorphSnapshots() { morphEngine.clearSnapshots(); }
+    bool hasMorphSnapshot(int slot) const { return morphEngine.hasSnapshot(slot); }
+    
+    // The filter settings in effect: the parameters, or while morphing, the morphed
+    // values at the current morph position. For the editor: while morphing this waits
+    // for the message thread to finish rebuilding the morph table, so it's no use to
+    // the audio thread or to host callbacks like getTailLengthSeconds().
+    struct FilterSettings
+    {
+        float cutoff = 1000.0f, resonance = 0.707f, gain = 0.0f;
+        int slopeIndex = 0, filterTypeIndex = 0, alignmentIndex = 0, stereoModeIndex = 0;
+        float cutoff2 = 1000.0f, resonance2 = 0.707f, gain2 = 0.0f;
+    };
+    
+    FilterSettings getFilterSettings() const;
+    
+    // Stereo modes: every channel runs filter set 0 (linked), or the right channel, or
+    // the side of a mid/side encoded pair, runs set 1 with its own cutoff, resonance and gain.
+    // Any further channels of a bigger bus follow the left one.
+    enum StereoMode { linkedStereo = 0, leftRightStereo, midSideStereo };
+    static constexpr int numFilterSets = 2;
+    
+    // Sample-accurate automation: schedules a parameter change (raw value) at a sample
+    // offset into the next processBlock call, which splits the block there. Audio thread
+    // only. The caller still sets the parameter itself, as a host does, so the editor and
+    // saved state follow. Returns false if the queue is full.
+    bool addParameterEvent(int sampleOffset, int parameterIndex, float rawValue) noexcept
+    {
+        return parameterEvents.add(sampleOffset, parameterIndex, rawValue);
+    }
+    
+    // True while the input has been silent for long enough for the filters to ring out:
+    // blocks are then output as silence without running any DSP, until the input returns
+    bool isSleeping() const noexcept { return sleeping.load(std::memory_order_relaxed); }
+    
 private:
     
     // Parameter pointers
@@ -72,25 +157,301 @@ private:
     juce::AudioParameterChoice* filterSlope = nullptr;
     juce::AudioParameterChoice* filterType = nullptr;
     juce::AudioParameterFloat* gain = nullptr;
+    juce::AudioParameterBool* truePeak = nullptr;
+    juce::AudioParameterFloat* lookahead = nullptr;
+    juce::AudioParameterChoice* oversampling = nullptr;
+    juce::AudioParameterChoice* oversamplingFilter = nullptr;
+    juce::AudioParameterFloat* morphX = nullptr;
+    juce::AudioParameterFloat* morphY = nullptr;
+    juce::AudioParameterChoice* filterAlignment = nullptr;
+    juce::AudioParameterChoice* stereoMode = nullptr;
+    juce::AudioParameterFloat* cutoffFreq2 = nullptr;
+    juce::AudioParameterFloat* resonance2 = nullptr;
+    juce::AudioParameterFloat* gain2 = nullptr;
+    
+    // Parameter smoothing, cutoff, resonance and gain once per filter set. While linked,
+    // set 1 follows set 0, so unlinking ramps from where the channels were.
+    std::array<juce::SmoothedValue<float>, numFilterSets> cutoffSmoothers, resonanceSmoothers, gainSmoothers;
+    juce::SmoothedValue<float> slopeSmoother; // 0 -> 1 crossfade for click-free slope transitions
+    
+    static constexpr int maxFilterStages = SIMDFilterCascade<float>::maxStages;
+    
+    // Largest bus accepted by isBusesLayoutSupported (enough for 3rd-order ambisonics
+    // and the biggest immersive beds)
+    static constexpr int maxSupportedChannels = 64;
+    
+    // Everything that processes audio, at one sample precision. There's a float and a
+    // double core; prepareToPlay only prepares the one the host processes with.
+    template <typename SampleType>
+    struct DSPCore
+    {
+        // Cascaded filter sections, as many as the slope needs (see FilterDesign):
+        // 6dB/oct is one one-pole section, 12dB/oct one state variable section, 18dB/oct
+        // both, and so on up to four sections for 48dB/oct. All channels are filtered
+        // together in SIMD-register-wide groups
+        SIMDFilterCascade<SampleType> filterChain;
+        
+        // Cached per-section coefficients of each filter set, and the set each channel
+        // of the chain runs (see assignFilterSets)
+        std::array<SVFCoefficientEngine<SampleType, maxFilterStages>, numFilterSets> coefficientEngines;
+        std::array<const SVFCoefficients<SampleType>*, maxSupportedChannels> channelCoefficients {};
+        
+        // Independent chain that keeps running the outgoing slope while a new one fades in
+        SIMDFilterCascade<SampleType> shadowFilterChain;
+        std::array<SVFCoefficientEngine<SampleType, maxFilterStages>, numFilterSets> shadowCoefficientEngines;
+        std::array<const SVFCoefficients<SampleType>*, maxSupportedChannels> shadowChannelCoefficients {};
+        
+        OutputLimiter<SampleType> outputLimiter; // Prevent signal exceeding -0.1dB
+        
+        // Oversampling around the filter chain; gain and limiter run at the host rate
+        FilterOversampling<SampleType> filterOversampling;
+        
+        // The outgoing oversampling factor's path, kept running on a copy of the input
+        // while a factor switch crossfades to the new one: its own filter state and
+        // coefficients at the old rate
+        SIMDFilterCascade<SampleType> outgoingRateFilterChain;
+        std::array<SVFCoefficientEngine<SampleType, maxFilterStages>, numFilterSets> outgoingRateCoefficientEngines;
+        std::array<const SVFCoefficients<SampleType>*, maxSupportedChannels> outgoingRateChannelCoefficients {};
+        juce::AudioBuffer<SampleType> outgoingRateBuffer;
+    };
+    
+    DSPCore<float> floatCore;
+    DSPCore<double> doubleCore;
+    
+    template <typename SampleType>
+    DSPCore<SampleType>& getCore() noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doubleCore;
+        else
+            return floatCore;
+    }
+    
+    // Calls function with the core matching the processing precision
+    template <typename Function>
+    void withActiveCore(Function&& function)
+    {
+        if (isUsingDoublePrecision())
+            function(doubleCore);
+        else
+            function(floatCore);
+    }
+    
+    // Slope and alignment together pick the layout, so changing either crossfades
+    int activeDesignIndex = 0;   // Design run by filterChain
+    int outgoingDesignIndex = 0; // Design run by shadowFilterChain during a transition
+    bool activeBandpass = false; // Bandpass has layouts of its own
+    const FilterDesign::CascadeLayout* activeLayout = &FilterDesign::getLayout(0, 0, false);
+    const FilterDesign::CascadeLayout* outgoingLayout = activeLayout;
+    int sharedSlopeStages = 0;   // Leading sections common to both, only computed once
+    int activeStereoMode = linkedStereo;
+    
+    static constexpr double maxLookaheadMs = 5.0;
+    
+    PerformanceCounters performanceCounters;
+    
+    using OversamplingDesign = FilterOversamplingDesigns::FilterDesign;
+    int maxOversamplingBlockSize = 0;
+    
+    static constexpr int autoOversamplingChoice = 4;           // "Auto" entry of the oversampling parameter
+    static constexpr int autoMaxOversamplingIndex = 2;         // Auto mode goes up to 4x
+    static constexpr float autoOversamplingThreshold = 0.35f;  // Fraction of Nyquist where auto mode steps up
+    
+    int activeOversamplingIndex = 0;  // 0 = 1x, 1 = 2x, 2 = 4x, 3 = 8x
+    OversamplingDesign activeOversamplingDesign = OversamplingDesign::polyphaseIIR;
+    bool activeOversamplingAuto = false;
+    int oversamplingPadding = 0;      // Delay that keeps auto mode's reported latency constant
+    int oversamplingDelayLine = 0;    // FilterOversampling delay line holding that padding
+    
+    // Factor switches crossfade from the outgoing path, which keeps running, to the new
+    // one over a fixed time, however many blocks that takes
+    static constexpr double oversamplingCrossfadeSeconds = 0.02;
+    juce::SmoothedValue<float> oversamplingCrossfade;  // New path's share, 0 -> 1
+    int outgoingOversamplingIndex = 0;
+    OversamplingDesign outgoingOversamplingDesign = OversamplingDesign::polyphaseIIR;
+    int outgoingOversamplingPadding = 0;
+    double currentSampleRate = 44100.0;
+    
+    // Session state encoding used by get/setStateInformation
+    BinaryStateFormat stateFormat;
+    
+    // The three-choice "slope" (6/12/24 dB/oct) of versions before 3 is still registered
+    // so automation recorded on it plays the same slopes: the host's changes to it are
+    // forwarded to filterSlope. Loading state or a preset sets both and doesn't forward,
+    // so the loaded filterSlope stands.
+    std::atomic<bool> loadingState { false };
+    
+    struct ScopedStateLoad
+    {
+        explicit ScopedStateLoad(std::atomic<bool>& flagToSet) : flag(flagToSet), previous(flag.exchange(true)) {}
+        ~ScopedStateLoad() { flag.store(previous); }
+        std::atomic<bool>& flag;
+        const bool previous;
+    };
+    
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    
+    // The morph snapshots go into the session state as a chunk of their own
+    static constexpr juce::uint32 morphChunkID = 0x4850524d;   // "MRPH" when read as little-endian bytes
+    void appendMorphSnapshots(juce::MemoryBlock& state) const;
+    void restoreMorphSnapshots(const juce::MemoryBlock& chunk);
+    
+    // Every parameter as the audio thread sees it for the current block, copied from
+    // the snapshot in one consistent read, and only when a parameter changed
+    struct BlockParameters
+    {
+        float cutoff = 1000.0f, resonance = 0.707f, gain = 0.0f, lookaheadMs = 0.0f;
+        int slopeIndex = 0, filterTypeIndex = 0, oversamplingChoice = 0, oversamplingFilterIndex = 0, alignmentIndex = 0;
+        bool truePeak = false;
+        float morphX = 0.0f, morphY = 0.0f;
+        int stereoModeIndex = 0;
+        float cutoff2 = 1000.0f, resonance2 = 0.707f, gain2 = 0.0f;
+    };
+    
+    // Interpolates between preset snapshots; its targets, in this order
+    MorphEngine morphEngine;
+    enum MorphTarget { morphCutoff = 0, morphResonance, morphGain, morphSlope, morphFilterType,
+                       morphAlignment, morphCutoff2, morphResonance2, morphGain2 };
+    
+    // Puts the morphed values in place of the parameters' (Settings is BlockParameters
+    // or FilterSettings)
+    template <typename Settings>
+    static void applyMorphedValues(const std::array<float, MorphEngine::maxTargets>& morphed, Settings& settings);
+    
+    ParameterSnapshot parameterSnapshot;
+    ParameterSnapshot::Values blockValues;  // What blockParameters was filled from
+    BlockParameters blockParameters;
+    juce::uint32 blockParametersVersion = 0;
+    
+    // Timestamped changes inside the next block, added by addParameterEvent()
+    ParameterEventQueue parameterEvents;
+    std::atomic<double> filterSampleRate { 44100.0 };
+    std::atomic<double> analyserSampleRate { 0.0 };  // Unknown until prepareToPlay
+    
+    // Silence detection: input below silenceThreshold for longer than the filters ring
+    // on (down by tailDecibels, which getTailLengthSeconds() also reports) puts the
+    // plugin to sleep
+    static constexpr double silenceThreshold = 1.0e-6;  // -120 dBFS
+    static constexpr double tailDecibels = 120.0;
+    juce::int64 silentInputSamples = 0;
+    std::atomic<bool> sleeping { false };
+    std::atomic<double> tailLengthSeconds { 0.0 };  // Published by updateTailLength()
+    
+    // Number of channels the filter state is sized for, set from the bus layout in prepareToPlay
+    int numChannels = 0;
+    
+    // True if the first numChannels channels are all below silenceThreshold
+    template <typename SampleType>
+    static bool isSilent(const juce::AudioBuffer<SampleType>& buffer, int numChannels);
+    
+    // Works out how long the filters ring on at their current targets, on the audio
+    // thread, and publishes it for getTailLengthSeconds()
+    void updateTailLength();
+    
+    // Silent input after which the output has rung out, at the last published tail
+    juce::int64 getSleepDelaySamples() const;
+    
+    // Flushes the state of every filter, oversampler and the limiter and stops processing
+    template <typename SampleType>
+    void goToSleep();
+    
+    // Takes the smoothers straight to their targets and the layout straight to the
+    // current slope and type, for when there's no signal to smooth
+    void settleParameters();
+    
+    // Hands the current slope over to the shadow chain and starts the crossfade
+    template <typename SampleType>
+    void beginSlopeTransition(int newDesignIndex);
+    
+    // Switches both chains between the lowpass/highpass and bandpass layouts
+    template <typename SampleType>
+    void setBandpassLayouts(bool bandpass);
+    
+    // Points each channel of both chains at the coefficients of its filter set for the
+    // stereo mode
+    void assignFilterSets(int newStereoMode);
+    
+    // Retargets the cutoff, resonance and gain smoothers of every filter set to blockParameters
+    void setFilterSetTargets();
+    
+    // True while any filter set's cutoff or resonance is ramping
+    bool isFilterSetSmoothing() const noexcept;
+    
+    // Index of a slope and alignment combination, and the layout it runs
+    static int getDesignIndex(int slopeIndex, int alignmentIndex) noexcept
+    {
+        return juce::jlimit(0, FilterDesign::numSlopes - 1, slopeIndex) + alignmentIndex * FilterDesign::numSlopes;
+    }
+    
+    static const FilterDesign::CascadeLayout& getDesignLayout(int designIndex, bool bandpass) noexcept
+    {
+        return FilterDesign::getLayout(designIndex % FilterDesign::numSlopes, designIndex / FilterDesign::numSlopes, bandpass);
+    }
+    
+    // Both processBlock() overloads, on the core of their precision
+    template <typename SampleType>
+    void processBuffer(juce::AudioBuffer<SampleType>& buffer);
+    
+    // Filters and applies gain to one stretch of the block between automation points.
+    // Returns true if any parameter was smoothing.
+    template <typename SampleType>
+    bool processSegment(const juce::dsp::AudioBlock<SampleType>& block);
+    
+    // Runs the filter chain over the block, oversampled if needed, and pads its latency.
+    // During a factor switch it also runs the outgoing path and crossfades the two.
+    template <typename SampleType>
+    void processFilter(const juce::dsp::AudioBlock<SampleType>& block,
+                       juce::dsp::StateVariableTPTFilterType filterMode, bool filterSmoothing);
+    
+    // Steady-state path: whole-block processing with a single set of coefficients
+    template <typename SampleType>
+    void processSettledBlock(const juce::dsp::AudioBlock<SampleType>& block,
+                             juce::dsp::StateVariableTPTFilterType filterMode);
+    
+    // Path used while parameters are smoothing: sub-block coefficient updates and
+    // the slope crossfade. The block may be oversampled by oversamplingFactor.
+    template <typename SampleType>
+    void processSmoothingBlock(const juce::dsp::AudioBlock<SampleType>& block,
+                               juce::dsp::StateVariableTPTFilterType filterMode, int oversamplingFactor);
+    
+    // Turns the first two channels into mid and side (encode) or back into left and right
+    template <typename SampleType>
+    static void convertMidSide(const juce::dsp::AudioBlock<SampleType>& block, bool encode) noexcept;
+    
+    // Applies each filter set's (possibly ramping) post-filter gain to its channels
+    template <typename SampleType>
+    void applyOutputGain(const juce::dsp::AudioBlock<SampleType>& block);
+    
+    // Pushes the true-peak and lookahead settings to the limiter and reports its latency
+    void updateLimiterMode();
+    
+    // Oversampling factor index wanted by the current settings (resolves auto mode)
+    int getWantedOversamplingIndex() const;
+    
+    // Switches the oversampling factor and design, and reports the new latency
+    void applyOversamplingSettings(int factorIndex, OversamplingDesign design, bool isAuto);
+    
+    // Hands the current oversampling path over to the outgoing one, switches, and starts
+    // the crossfade
+    template <typename SampleType>
+    void beginOversamplingSwitch(int factorIndex, OversamplingDesign design, bool isAuto);
     
-    // Parameter smoothing
-    juce::SmoothedValue<float> cutoffSmoother, resonanceSmoother, gainSmoother;
-    juce::SmoothedValue<float> slopeSmoother; // For click-free slope transitions
+    // True if the outgoing path of the running crossfade needs its own oversampler and
+    // filter chain (false if only the padding changed)
+    bool isOutgoingOversamplingSeparate() const noexcept;
     
-    // DSP processing components - Cascaded filters for different slopes
-    // 6dB/oct: 1 filter
-    // 12dB/oct: 2 filters cascaded
-    // 24dB/oct: 4 filters cascaded
-    static constexpr int maxFilterStages = 4;
-    std::array<juce::dsp::StateVariableTPTFilter<float>, maxFilterStages> filterChain;
+    // Reports oversampling plus limiter latency to the host
+    void updateLatency();
     
-    juce::dsp::Limiter<float> outputLimiter; // Prevent signal exceeding -0.1dB
+    // Refreshes blockParameters from the snapshot. Returns false, without reading
+    // anything, if no parameter changed since the last call.
+    bool updateBlockParameters(bool force = false);
     
-    // Filter state variables for multichannel processing
-    int numChannels = 2;
+    // Fills blockParameters from blockValues
+    void applyBlockValues();
     
-    // Helper function to get number of filter stages for slope
-    int getSlopeFilterStages(int slopeIndex) const;
+    // Moves one parameter to an automation point's value and retargets its smoother
+    void applyParameterEvent(const ParameterEventQueue::Event& event);
     
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NewPluginSkeletonAudioProcessor)
@@ -0,0 +1,437 @@
+/*
+  ==============================================================================
+
+    Searchable index of the preset library.
+
+  ==============================================================================
+*/
+
+#include "PresetIndex.h"
+#include "FilterDesign.h"
+#include <algorithm>
+
+namespace
+{
+    int getChoiceIndex (const juce::NamedValueSet& values, const juce::Identifier& parameterID)
+    {
+        if (auto* value = values.getVarPointer (parameterID))
+            return juce::roundToInt (static_cast<double> (*value));
+
+        return -1;
+    }
+
+    int findChoice (const juce::String& value, const juce::StringArray& choices)
+    {
+        if (value.isNotEmpty())
+            for (int i = 0; i < choices.size(); ++i)
+                if (choices[i].startsWithIgnoreCase (value))
+                    return i;
+
+        return -1;
+    }
+
+    // The word's characters in order anywhere in the name; the fewer characters
+    // skipped between the first and last match, the higher the score
+    int getFuzzyScore (const juce::String& word, const juce::String& name)
+    {
+        const auto lowerName = name.toLowerCase();
+        int position = 0, first = -1, last = -1;
+
+        for (auto p = word.toLowerCase().getCharPointer(); ! p.isEmpty();)
+        {
+            const auto found = lowerName.indexOfChar (position, p.getAndAdvance());
+
+            if (found < 0)
+                return 0;
+
+            if (first < 0)
+                first = found;
+
+            last = found;
+            position = found + 1;
+        }
+
+        const auto skipped = (last - first + 1) - word.length();
+        return juce::jmax (1, 50 - skipped);
+    }
+
+    int getWordScore (const juce::String& word, const PresetIndex::Entry& entry)
+    {
+        if (entry.name.startsWithIgnoreCase (word))
+            return 400;
+
+        for (const auto& nameWord : juce::StringArray::fromTokens (entry.name, " -_", ""))
+            if (nameWord.startsWithIgnoreCase (word))
+                return 300;
+
+        for (const auto& tag : entry.tags)
+            if (tag.startsWithIgnoreCase (word))
+                return 200;
+
+        if (entry.name.containsIgnoreCase (word))
+            return 100;
+
+        return getFuzzyScore (word, entry.name);
+    }
+
+    void setChoiceIndices (PresetIndex::Entry& entry)
+    {
+        entry.filterType = getChoiceIndex (entry.values, "filterType");
+        entry.slope = getChoiceIndex (entry.values, "filterSlope");
+    }
+}
+
+//==============================================================================
+PresetIndex::Query PresetIndex::Query::parse (const juce::String& searchText,
+                                              const juce::StringArray& typeChoices,
+                                              const juce::StringArray& slopeChoices)
+{
+    Query query;
+    juce::StringArray words;
+
+    for (const auto& token : juce::StringArray::fromTokens (searchText, true))
+    {
+        const auto value = token.fromFirstOccurrenceOf (":", false, false);
+
+        if (token.startsWithIgnoreCase ("type:"))
+            query.filterType = findChoice (value, typeChoices);
+        else if (token.startsWithIgnoreCase ("slope:"))
+            query.slope = findChoice (value, slopeChoices);
+        else if (token.isNotEmpty())
+            words.add (token);
+    }
+
+    query.text = words.joinIntoString (" ");
+    return query;
+}
+
+//==============================================================================
+PresetIndex::PresetIndex()
+    : PresetIndex (getDefaultPresetDirectory(),
+                   getDefaultPresetDirectory().getSiblingFile ("PresetIndex.cache"),
+                   true)
+{
+}
+
+PresetIndex::PresetIndex (const juce::File& presetDirectory, const juce::File& indexCacheFile, bool startScanner)
+    : juce::Thread ("Preset index"),
+      directory (presetDirectory),
+      cacheFile (indexCacheFile),
+      entries (std::make_shared<const EntryList>())
+{
+    if (startScanner)
+        startThread();
+}
+
+PresetIndex::~PresetIndex()
+{
+    stopThread (4000);
+}
+
+juce::File PresetIndex::getDefaultPresetDirectory()
+{
+    auto appDataDir = juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory);
+
+   #if JUCE_MAC
+    return appDataDir.getChildFile ("Audio/Presets/Franky's Filters");
+   #elif JUCE_WINDOWS
+    return appDataDir.getChildFile ("Franky's Filters/Presets");
+   #else
+    return appDataDir.getChildFile (".FrankysFilters/Presets");
+   #endif
+}
+
+//==============================================================================
+void PresetIndex::rescan()
+{
+    notify();
+}
+
+void PresetIndex::run()
+{
+    while (! threadShouldExit())
+    {
+        scan();
+        wait (rescanIntervalMs);
+    }
+}
+
+bool PresetIndex::scan()
+{
+    const juce::ScopedLock sl (scanLock);
+    bool changed = false;
+
+    if (! cacheLoaded)
+    {
+        cacheLoaded = true;
+        changed = loadCache();
+    }
+
+    if (! directory.isDirectory() && ! directory.createDirectory())
+        return changed;
+
+    const auto previous = getEntries();
+    std::map<juce::String, EntryPtr> known;
+
+    for (const auto& entry : *previous)
+        known.emplace (entry->file.getFullPathName(), entry);
+
+    EntryList list;
+    list.reserve (previous->size());
+    bool listChanged = false;
+
+    for (const auto& item : juce::RangedDirectoryIterator (directory, true, "*.xml", juce::File::findFiles))
+    {
+        if (threadShouldExit())
+            return changed;
+
+        const auto file = item.getFile();
+        const auto path = file.getFullPathName();
+        const auto modificationTime = item.getModificationTime().toMilliseconds();
+
+        // Unchanged since the last scan (or the cache): keep the entry as it is
+        const auto found = known.find (path);
+        const bool wasKnown = found != known.end();
+
+        if (wasKnown)
+        {
+            auto entry = found->second;
+            known.erase (found);
+
+            if (entry->modificationTime == modificationTime && entry->fileSize == item.getFileSize())
+            {
+                list.push_back (std::move (entry));
+                continue;
+            }
+        }
+        else
+        {
+            const auto unreadable = unreadableFiles.find (path);
+
+            if (unreadable != unreadableFiles.end() && unreadable->second == modificationTime)
+                continue;
+        }
+
+        if (auto entry = readPresetFile (file, directory))
+        {
+            list.push_back (std::move (entry));
+            unreadableFiles.erase (path);
+            listChanged = true;
+        }
+        else
+        {
+            unreadableFiles[path] = modificationTime;
+            listChanged = listChanged || wasKnown;
+        }
+    }
+
+    // Anything left over was deleted
+    if (! listChanged && known.empty())
+        return changed;
+
+    std::sort (list.begin(), list.end(), [] (const EntryPtr& a, const EntryPtr& b)
+    {
+        const auto order = a->name.compareNatural (b->name);
+        return order != 0 ? order < 0 : a->file.getFullPathName() < b->file.getFullPathName();
+    });
+
+    writeCache (list);
+    publish (std::move (list));
+    return true;
+}
+
+//==============================================================================
+std::shared_ptr<const PresetIndex::EntryList> PresetIndex::getEntries() const
+{
+    const juce::SpinLock::ScopedLockType sl (entriesLock);
+    return entries;
+}
+
+PresetIndex::EntryList PresetIndex::search (const Query& query, int maxResults) const
+{
+    const auto list = getEntries();
+    std::vector<std::pair<int, EntryPtr>> matches;
+
+    for (const auto& entry : *list)
+    {
+        if ((query.filterType >= 0 && entry->filterType != query.filterType)
+         || (query.slope >= 0 && entry->slope != query.slope))
+            continue;
+
+        if (const auto score = getMatchScore (query.text, *entry); score > 0)
+            matches.emplace_back (score, entry);
+    }
+
+    // The list is sorted by name, so a stable sort keeps equal scores in name order
+    std::stable_sort (matches.begin(), matches.end(), [] (const auto& a, const auto& b) { return a.first > b.first; });
+
+    EntryList results;
+    results.reserve ((size_t) juce::jmin ((int) matches.size(), juce::jmax (0, maxResults)));
+
+    for (auto& match : matches)
+    {
+        if ((int) results.size() >= maxResults)
+            break;
+
+        results.push_back (std::move (match.second));
+    }
+
+    return results;
+}
+
+int PresetIndex::getMatchScore (const juce::String& text, const Entry& entry)
+{
+    const auto words = juce::StringArray::fromTokens (text, true);
+    int total = 1;
+
+    for (const auto& word : words)
+    {
+        if (word.isEmpty())
+            continue;
+
+        const auto score = getWordScore (word, entry);
+
+        if (score == 0)
+            return 0;
+
+        total += score;
+    }
+
+    return total;
+}
+
+PresetIndex::EntryPtr PresetIndex::readPresetFile (const juce::File& file, const juce::File& presetDirectory)
+{
+    const auto xml = juce::parseXML (file);
+
+    if (xml == nullptr || ! xml->hasTagName ("Parameters"))
+        return nullptr;
+
+    auto entry = std::make_shared<Entry>();
+    entry->file = file;
+    entry->name = file.getFileNameWithoutExtension();
+    entry->modificationTime = file.getLastModificationTime().toMilliseconds();
+    entry->fileSize = file.getSize();
+
+    // Sub-folders of the library act as tags too
+    entry->tags.addTokens (xml->getStringAttribute ("tags"), ",", "\"");
+
+    for (auto folder = file.getParentDirectory(); folder.isAChildOf (presetDirectory); folder = folder.getParentDirectory())
+        entry->tags.add (folder.getFileName());
+
+    entry->tags.trim();
+    entry->tags.removeEmptyStrings();
+    entry->tags.removeDuplicates (true);
+
+    for (auto* parameter : xml->getChildWithTagNameIterator ("PARAM"))
+        if (parameter->hasAttribute ("id"))
+            entry->values.set (parameter->getStringAttribute ("id"), parameter->getDoubleAttribute ("value"));
+
+    // Before version 3 the slope was saved as "slope", and presets saved before the
+    // state had a version only knew 6, 12 and 24 dB/oct
+    const int version = xml->getIntAttribute ("version", 1);
+
+    if (version < 3 && ! entry->values.contains ("filterSlope"))
+    {
+        if (auto* slope = entry->values.getVarPointer ("slope"))
+        {
+            const int slopeIndex = juce::roundToInt (static_cast<double> (*slope));
+            entry->values.set ("filterSlope", version < 2 ? FilterDesign::getSlopeIndexFromVersion1 (slopeIndex) : slopeIndex);
+        }
+    }
+
+    setChoiceIndices (*entry);
+    return entry;
+}
+
+//==============================================================================
+bool PresetIndex::loadCache()
+{
+    juce::FileInputStream stream (cacheFile);
+
+    if (! stream.openedOk())
+        return false;
+
+    const auto tree = juce::ValueTree::readFromStream (stream);
+
+    if (! tree.hasType ("PresetIndex") || static_cast<int> (tree.getProperty ("version")) != cacheVersion)
+        return false;
+
+    EntryList list;
+    list.reserve ((size_t) tree.getNumChildren());
+
+    for (const auto& child : tree)
+    {
+        auto entry = std::make_shared<Entry>();
+        entry->file = directory.getChildFile (child["path"].toString());
+        entry->name = child["name"].toString();
+        entry->tags.addLines (child["tags"].toString());
+        entry->modificationTime = static_cast<juce::int64> (child["modified"]);
+        entry->fileSize = static_cast<juce::int64> (child["size"]);
+
+        const auto values = child.getChildWithName ("Values");
+
+        for (int i = 0; i < values.getNumProperties(); ++i)
+        {
+            const auto parameterID = values.getPropertyName (i);
+            entry->values.set (parameterID, values[parameterID]);
+        }
+
+        setChoiceIndices (*entry);
+        list.push_back (std::move (entry));
+    }
+
+    publish (std::move (list));
+    return true;
+}
+
+void PresetIndex::writeCache (const EntryList& list) const
+{
+    juce::ValueTree tree ("PresetIndex");
+    tree.setProperty ("version", cacheVersion, nullptr);
+
+    for (const auto& entry : list)
+    {
+        juce::ValueTree child ("Preset");
+        child.setProperty ("path", entry->file.getRelativePathFrom (directory), nullptr);
+        child.setProperty ("name", entry->name, nullptr);
+        child.setProperty ("tags", entry->tags.joinIntoString ("\n"), nullptr);
+        child.setProperty ("modified", entry->modificationTime, nullptr);
+        child.setProperty ("size", entry->fileSize, nullptr);
+
+        juce::ValueTree values ("Values");
+
+        for (const auto& value : entry->values)
+            values.setProperty (value.name, value.value, nullptr);
+
+        child.appendChild (values, nullptr);
+        tree.appendChild (child, nullptr);
+    }
+
+    // Written next to the old cache and swapped in, so a crash never leaves half a file
+    juce::TemporaryFile temporary (cacheFile);
+
+    {
+        juce::FileOutputStream stream (temporary.getFile());
+
+        if (! stream.openedOk())
+            return;
+
+        tree.writeToStream (stream);
+    }
+
+    temporary.overwriteTargetFileWithTemporary();
+}
+
+void PresetIndex::publish (EntryList list)
+{
+    auto newEntries = std::make_shared<const EntryList> (std::move (list));
+
+    {
+        const juce::SpinLock::ScopedLockType sl (entriesLock);
+        entries.swap (newEntries);
+    }
+
+    // The old list (now in newEntries) is released here, outside the lock
+    sendChangeMessage();
+}
@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    Searchable index of the preset library.
+
+    A background thread keeps an in-memory list of every preset (name, tags,
+    parameter values, modification time) in sync with the preset directory.
+    Only files whose modification time or size changed since the last scan
+    are parsed again, and the list is saved to an on-disk cache so a fresh
+    editor has the whole library without reading thousands of XML files.
+
+    The message thread never touches the filesystem: it searches the most
+    recent list and loads presets from the values stored in it. Listeners
+    are told (asynchronously, on the message thread) whenever the list
+    changes.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_events/juce_events.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+class PresetIndex : public juce::ChangeBroadcaster,
+                    private juce::Thread
+{
+public:
+    //==============================================================================
+    struct Entry
+    {
+        juce::File file;
+        juce::String name;
+        juce::StringArray tags;             // From the preset's "tags" attribute and its sub-folders
+        juce::NamedValueSet values;         // Raw parameter values by parameter ID
+        int filterType = -1, slope = -1;    // Choice indices, -1 if the preset doesn't set them
+        juce::int64 modificationTime = 0, fileSize = 0;
+    };
+
+    using EntryPtr = std::shared_ptr<const Entry>;
+    using EntryList = std::vector<EntryPtr>;
+
+    struct Query
+    {
+        juce::String text;
+        int filterType = -1, slope = -1;    // -1 = any
+
+        /** Splits "type:<choice>" and "slope:<choice>" tokens off the search text. A value
+            selects the first choice name it's the start of, e.g. "type:high" or "slope:24".
+        */
+        static Query parse (const juce::String& searchText,
+                            const juce::StringArray& typeChoices,
+                            const juce::StringArray& slopeChoices);
+    };
+
+    //==============================================================================
+    /** Indexes the default preset directory and starts the background scanner. */
+    PresetIndex();
+
+    /** Indexes presetDirectory, caching to cacheFile. Without the scanner nothing is
+        read until scan() is called.
+    */
+    PresetIndex (const juce::File& presetDirectory, const juce::File& cacheFile, bool startScanner);
+
+    ~PresetIndex() override;
+
+    static juce::File getDefaultPresetDirectory();
+
+    const juce::File& getPresetDirectory() const noexcept   { return directory; }
+
+    //==============================================================================
+    /** Asks the scanner to look for changes now, e.g. after saving a preset. */
+    void rescan();
+
+    /** Brings the index up to date on the calling thread (loading the cache first, if
+        that hasn't happened yet). Returns true if the list changed.
+    */
+    bool scan();
+
+    /** Every indexed preset, sorted by name. Shares the scanner's list, so it's cheap. */
+    std::shared_ptr<const EntryList> getEntries() const;
+
+    /** Presets matching the query, best first (then by name), at most maxResults. */
+    EntryList search (const Query& query, int maxResults = 1000) const;
+
+    /** 0 if the entry doesn't match; higher is better. Every word of the text has to
+        match the start of the name, a word in it or a tag, appear somewhere in the name,
+        or failing all those, appear in the name as a subsequence (fuzzy match).
+    */
+    static int getMatchScore (const juce::String& text, const Entry& entry);
+
+    /** Parses a preset as saved by the editor; nullptr if the file isn't one. */
+    static EntryPtr readPresetFile (const juce::File& file, const juce::File& presetDirectory);
+
+private:
+    //==============================================================================
+    void run() override;
+
+    bool loadCache();
+    void writeCache (const EntryList& list) const;
+    void publish (EntryList list);
+
+    const juce::File directory, cacheFile;
+
+    juce::CriticalSection scanLock;                    // One scan at a time
+    bool cacheLoaded = false;
+    std::map<juce::String, juce::int64> unreadableFiles;  // Path -> modification time, so they aren't re-parsed
+
+    mutable juce::SpinLock entriesLock;
+    std::shared_ptr<const EntryList> entries;
+
+    static constexpr int rescanIntervalMs = 10000;
+    static constexpr int cacheVersion = 2;             // 2: slope indices of version 1 presets upgraded
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PresetIndex)
+};
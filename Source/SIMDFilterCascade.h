@@ -0,0 +1,293 @@
+/*
+  ==============================================================================
+
+    Vectorised cascade of state variable (and one-pole) filter sections.
+
+    Channels are processed in groups as wide as a SIMD register: each group is
+    interleaved into a scratch buffer of frames, run through the active stages
+    and written back. Every channel has its own coefficients (one per lane of
+    the register), so channels filtered differently, e.g. the left and right or
+    mid and side of a stereo signal, still share a single register operation.
+    They do all share the same layout and filter type.
+
+    process() runs the layout's compiled cascade (see FilterDesign.h), which
+    takes each frame through every stage in one pass. The slope crossfade has
+    to tap the signal between stages, so it runs one stage at a time instead.
+
+    juce::dsp::SIMDRegister gives SSE on x86 and NEON on ARM. On Linux x86-64
+    builds an 8-lane AVX2 kernel is also compiled in and picked at runtime
+    when the CPU supports it and there are enough channels to fill it.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <type_traits>
+#include "StateVariableFilter.h"
+#include "FilterKernels.h"
+#include "FilterDesign.h"
+
+template <typename SampleType>
+class SIMDFilterCascade
+{
+public:
+    using Type = juce::dsp::StateVariableTPTFilterType;
+    using Register = juce::dsp::SIMDRegister<SampleType>;
+
+    static constexpr int maxStages = FilterDesign::maxSections;
+
+    //==============================================================================
+    /** Allocates the state and scratch space. Must not be called on the audio thread. */
+    void prepare (int newNumChannels, int maximumBlockSize)
+    {
+        numChannels = juce::jmax (1, newNumChannels);
+        maxFrames = juce::jmax (1, maximumBlockSize);
+
+        chooseKernel();
+        numGroups = (numChannels + laneWidth - 1) / laneWidth;
+
+        const auto frameElements = (size_t) (maxFrames * laneWidth);
+        const auto stateElements = (size_t) getStateSize();
+        const auto coefficientElements = (size_t) getStateSize() * 3 / 2;
+
+        storage.calloc (frameElements + stateElements + coefficientElements + alignment / sizeof (SampleType));
+        frames = juce::snapPointerToAlignment (storage.get(), alignment);
+        state = frames + frameElements;
+        laneCoefficients = state + stateElements;
+    }
+
+    /** Clears the state of every stage. */
+    void reset() noexcept
+    {
+        std::fill (state, state + getStateSize(), SampleType (0));
+    }
+
+    /** Clears the state of stages [firstStage, maxStages), e.g. ones that were inactive. */
+    void resetStages (int firstStage) noexcept
+    {
+        for (int group = 0; group < numGroups; ++group)
+            for (int stage = firstStage; stage < maxStages; ++stage)
+                std::fill (getState (group, stage), getState (group, stage) + 2 * laneWidth, SampleType (0));
+    }
+
+    /** Copies the filter state from a cascade prepared with the same settings. */
+    void copyStateFrom (const SIMDFilterCascade& other) noexcept
+    {
+        jassert (other.numChannels == numChannels && other.laneWidth == laneWidth);
+        std::copy (other.state, other.state + getStateSize(), state);
+    }
+
+    //==============================================================================
+    /** Filters the block in place through the layout's sections. channelCoefficients
+        holds, for every channel, a pointer to an entry for each of the sections, as
+        computed for this layout; channels may share them.
+    */
+    void process (const juce::dsp::AudioBlock<SampleType>& block, const FilterDesign::CascadeLayout& layout,
+                  const SVFCoefficients<SampleType>* const* channelCoefficients, Type type) noexcept
+    {
+        const auto channelsToProcess = juce::jmin ((int) block.getNumChannels(), numChannels);
+        const auto numSamples = (int) block.getNumSamples();
+
+        // Picked and packed once for the whole block
+        const auto kernel = cascadeKernelLookup (layout.id, (int) type);
+        packCoefficients (channelCoefficients, channelsToProcess, 0, layout.numSections);
+
+        for (int start = 0; start < numSamples; start += maxFrames)
+        {
+            const auto numFrames = juce::jmin (maxFrames, numSamples - start);
+
+            for (int group = 0; group < numGroups; ++group)
+            {
+                const auto firstChannel = group * laneWidth;
+                const auto lanesUsed = juce::jmin (laneWidth, channelsToProcess - firstChannel);
+
+                if (lanesUsed <= 0)
+                    break;
+
+                interleave (block, firstChannel, lanesUsed, start, numFrames);
+                kernel (frames, numFrames, getState (group, 0), getLaneCoefficients (group, 0));
+                deinterleave (block, firstChannel, lanesUsed, start, numFrames);
+            }
+        }
+    }
+
+    /** Crossfades from an outgoing configuration, run by the shadow cascade, to this one.
+
+        The first sharedStages sections must be identical in both configurations:
+        they are only computed once and the shadow takes its input from their
+        output, so it only runs the sections that actually differ. fadeIn holds
+        one gain per sample, going from 0 (all shadow) to 1 (all this cascade).
+        The block must not be longer than the maximum block size passed to prepare().
+    */
+    void processCrossfade (const juce::dsp::AudioBlock<SampleType>& block, int numStages,
+                           const SVFCoefficients<SampleType>* const* channelCoefficients,
+                           SIMDFilterCascade& shadow, int shadowStages,
+                           const SVFCoefficients<SampleType>* const* shadowChannelCoefficients,
+                           int sharedStages, Type type, const SampleType* fadeIn) noexcept
+    {
+        jassert (shadow.laneWidth == laneWidth && (int) block.getNumSamples() <= maxFrames);
+
+        const auto channelsToProcess = juce::jmin ((int) block.getNumChannels(), numChannels);
+        const auto numFrames = (int) block.getNumSamples();
+
+        packCoefficients (channelCoefficients, channelsToProcess, 0, numStages);
+        shadow.packCoefficients (shadowChannelCoefficients, channelsToProcess, sharedStages, shadowStages);
+
+        for (int group = 0; group < numGroups; ++group)
+        {
+            const auto firstChannel = group * laneWidth;
+            const auto lanesUsed = juce::jmin (laneWidth, channelsToProcess - firstChannel);
+
+            if (lanesUsed <= 0)
+                break;
+
+            interleave (block, firstChannel, lanesUsed, 0, numFrames);
+            processStages (group, numFrames, 0, sharedStages, channelCoefficients[0], type);
+
+            std::copy (frames, frames + numFrames * laneWidth, shadow.frames);
+
+            processStages (group, numFrames, sharedStages, numStages, channelCoefficients[0], type);
+            shadow.processStages (group, numFrames, sharedStages, shadowStages, shadowChannelCoefficients[0], type);
+
+            for (int lane = 0; lane < lanesUsed; ++lane)
+            {
+                const auto* incoming = frames + lane;
+                const auto* outgoing = shadow.frames + lane;
+                auto* dest = block.getChannelPointer ((size_t) (firstChannel + lane));
+
+                for (int i = 0; i < numFrames; ++i)
+                    dest[i] = outgoing[i * laneWidth] + (incoming[i * laneWidth] - outgoing[i * laneWidth]) * fadeIn[i];
+            }
+        }
+    }
+
+    /** Number of channels filtered together by one register operation. */
+    int getLaneWidth() const noexcept   { return laneWidth; }
+
+private:
+    //==============================================================================
+    using StageKernel = void (*) (SampleType*, int, SampleType*, SampleType*, const SampleType*, int) noexcept;
+    using CascadeKernelLookup = FilterKernels::CascadeKernel<SampleType> (*) (int, int) noexcept;
+
+    static constexpr size_t alignment = 64;
+
+    void chooseKernel()
+    {
+        laneWidth = (int) Register::size();
+        stageKernel = FilterKernels::processStage<Register, SampleType>;
+        cascadeKernelLookup = FilterDesign::getCascadeKernel<Register, SampleType>;
+
+       #if FRANKYS_FILTERS_AVX2_KERNEL
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            // The wider kernel only pays off once there are more channels than SSE lanes
+            if (laneWidth < FilterKernels::avx2Width && numChannels > laneWidth && juce::SystemStats::hasAVX2())
+            {
+                laneWidth = FilterKernels::avx2Width;
+                stageKernel = FilterKernels::processStageAVX2;
+                cascadeKernelLookup = FilterKernels::getCascadeKernelAVX2;
+            }
+        }
+       #endif
+    }
+
+    int getStateSize() const noexcept
+    {
+        return numGroups * maxStages * 2 * laneWidth;
+    }
+
+    SampleType* getState (int group, int stage) const noexcept
+    {
+        return state + (group * maxStages + stage) * 2 * laneWidth;
+    }
+
+    SampleType* getLaneCoefficients (int group, int stage) const noexcept
+    {
+        return laneCoefficients + (group * maxStages + stage) * 3 * laneWidth;
+    }
+
+    /** Spreads the channels' coefficients of stages [firstStage, endStage) across the
+        lanes of their groups. Unused lanes take the first channel's, so they stay stable.
+    */
+    void packCoefficients (const SVFCoefficients<SampleType>* const* channelCoefficients,
+                           int channelsToProcess, int firstStage, int endStage) noexcept
+    {
+        for (int group = 0; group < numGroups; ++group)
+        {
+            for (int stage = firstStage; stage < endStage; ++stage)
+            {
+                auto* dest = getLaneCoefficients (group, stage);
+
+                for (int lane = 0; lane < laneWidth; ++lane)
+                {
+                    const auto channel = group * laneWidth + lane;
+                    const auto& c = channelCoefficients[channel < channelsToProcess ? channel : 0][stage];
+
+                    dest[lane] = c.g;
+                    dest[laneWidth + lane] = c.R2;
+                    dest[2 * laneWidth + lane] = c.h;
+                }
+            }
+        }
+    }
+
+    // The section kinds come from the layout, so every channel's are the same
+    void processStages (int group, int numFrames, int firstStage, int endStage,
+                        const SVFCoefficients<SampleType>* stageCoefficients, Type type) noexcept
+    {
+        for (int stage = firstStage; stage < endStage; ++stage)
+        {
+            auto* s1 = getState (group, stage);
+
+            stageKernel (frames, numFrames, s1, s1 + laneWidth, getLaneCoefficients (group, stage),
+                         FilterKernels::getStageType (stageCoefficients[stage].kind, (int) type));
+        }
+    }
+
+    void interleave (const juce::dsp::AudioBlock<SampleType>& block, int firstChannel, int lanesUsed,
+                     int startSample, int numFrames) noexcept
+    {
+        for (int lane = 0; lane < laneWidth; ++lane)
+        {
+            auto* dest = frames + lane;
+
+            if (lane < lanesUsed)
+            {
+                const auto* src = block.getChannelPointer ((size_t) (firstChannel + lane)) + startSample;
+
+                for (int i = 0; i < numFrames; ++i)
+                    dest[i * laneWidth] = src[i];
+            }
+            else
+            {
+                for (int i = 0; i < numFrames; ++i)
+                    dest[i * laneWidth] = SampleType (0);
+            }
+        }
+    }
+
+    void deinterleave (const juce::dsp::AudioBlock<SampleType>& block, int firstChannel, int lanesUsed,
+                       int startSample, int numFrames) noexcept
+    {
+        for (int lane = 0; lane < lanesUsed; ++lane)
+        {
+            const auto* src = frames + lane;
+            auto* dest = block.getChannelPointer ((size_t) (firstChannel + lane)) + startSample;
+
+            for (int i = 0; i < numFrames; ++i)
+                dest[i] = src[i * laneWidth];
+        }
+    }
+
+    //==============================================================================
+    int numChannels = 0, maxFrames = 0, numGroups = 0, laneWidth = 1;
+    StageKernel stageKernel = nullptr;
+    CascadeKernelLookup cascadeKernelLookup = nullptr;
+
+    juce::HeapBlock<SampleType> storage;
+    SampleType* frames = nullptr;   // maxFrames interleaved frames of laneWidth samples
+    SampleType* state = nullptr;    // [group][stage] { s1[laneWidth], s2[laneWidth] }
+    SampleType* laneCoefficients = nullptr;   // [group][stage] { g[laneWidth], R2[laneWidth], h[laneWidth] }
+};
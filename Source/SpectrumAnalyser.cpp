@@ -0,0 +1,262 @@
+/*
+  ==============================================================================
+
+    Live pre/post-filter spectrum display.
+
+  ==============================================================================
+*/
+
+#include "SpectrumAnalyser.h"
+
+namespace
+{
+    // Display levels jump up immediately and fall back by this much per hop
+    // (about 70 dB/s at 48kHz), so transients stay visible for a moment
+    constexpr float decayPerHop = 0.75f;
+
+    // Horizontal resolution of the drawn path; the bands are finer than this on
+    // the right-hand side, and nobody can see the difference
+    constexpr float pixelsPerPoint = 2.0f;
+}
+
+//==============================================================================
+SpectrumAnalyser::SpectrumAnalyser (NewPluginSkeletonAudioProcessor& p)
+    : juce::Thread ("Spectrum analyser"), processor (p)
+{
+    input.levels.fill (minDecibels);
+    output.levels.fill (minDecibels);
+    displayInput.fill (minDecibels);
+    displayOutput.fill (minDecibels);
+
+    setInterceptsMouseClicks (false, false);
+
+    processor.analyserEnabled.store (true);
+    startThread();
+}
+
+SpectrumAnalyser::~SpectrumAnalyser()
+{
+    processor.analyserEnabled.store (false);
+    stopThread (1000);
+    cancelPendingUpdate();
+}
+
+//==============================================================================
+void SpectrumAnalyser::run()
+{
+    while (! threadShouldExit())
+    {
+        // Published by the processor; AudioProcessor::getSampleRate() isn't safe to read from here
+        const auto sampleRate = processor.getAnalyserSampleRate();
+
+        if (sampleRate > 0.0 && sampleRate != mappedSampleRate)
+            updateBandMapping (sampleRate);
+
+        const bool inputChanged = analyse (input);
+        const bool outputChanged = analyse (output);
+
+        if (inputChanged || outputChanged)
+        {
+            const juce::SpinLock::ScopedLockType lock (levelsLock);
+            publishedInput = input.levels;
+            publishedOutput = output.levels;
+
+            if (! levelsChanged.exchange (true))
+                triggerAsyncUpdate();
+        }
+        else
+        {
+            wait (10);
+        }
+    }
+}
+
+bool SpectrumAnalyser::analyse (Analysis& analysis)
+{
+    // Take every complete hop that's waiting, but only transform the latest window:
+    // if this thread fell behind there's no point drawing frames nobody will see
+    int numHops = 0;
+    const int numChannels = analysis.fifo.getNumChannels();
+    std::array<float*, AnalyserFifo::maxChannels> hopDestinations {};
+
+    while (analysis.fifo.getNumReady() >= hopSize)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& history = analysis.history[(size_t) ch];
+            std::move (history.begin() + hopSize, history.end(), history.begin());
+            hopDestinations[(size_t) ch] = history.data() + fftSize - hopSize;
+        }
+
+        analysis.fifo.pull (hopDestinations.data(), numChannels, hopSize);
+        ++numHops;
+    }
+
+    if (numHops == 0 || numChannels == 0 || mappedSampleRate <= 0.0)
+        return false;
+
+    // Each channel is transformed on its own and their power averaged, so signals
+    // out of phase between channels show up rather than cancelling
+    auto& fftData = analysis.fftData;
+    auto& magnitudes = analysis.magnitudes;
+    std::fill (magnitudes.begin(), magnitudes.end(), 0.0f);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const auto& history = analysis.history[(size_t) ch];
+        std::copy (history.begin(), history.end(), fftData.begin());
+        std::fill (fftData.begin() + fftSize, fftData.end(), 0.0f);
+
+        window.multiplyWithWindowingTable (fftData.data(), (size_t) fftSize);
+        fft.performFrequencyOnlyForwardTransform (fftData.data());
+
+        for (size_t bin = 0; bin < magnitudes.size(); ++bin)
+            magnitudes[bin] += fftData[bin] * fftData[bin];
+    }
+
+    for (auto& magnitude : magnitudes)
+        magnitude = std::sqrt (magnitude / (float) numChannels);
+
+    // The Hann window halves a sine's amplitude, and a real sine's energy is split
+    // between positive and negative frequencies: a full-scale sine reads 0 dB
+    const float scale = 4.0f / (float) fftSize;
+    const float decay = decayPerHop * (float) numHops;
+    bool changed = false;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        const float startBin = bandStartBin[(size_t) band];
+        const float endBin = bandEndBin[(size_t) band];
+        float magnitude = 0.0f;
+
+        if (endBin - startBin < 1.0f)
+        {
+            // Bands narrower than a bin (low frequencies) interpolate between bins
+            const int bin = (int) startBin;
+            const float fraction = startBin - (float) bin;
+            magnitude = magnitudes[(size_t) bin] + fraction * (magnitudes[(size_t) bin + 1] - magnitudes[(size_t) bin]);
+        }
+        else
+        {
+            // Wider bands show their loudest bin, so narrow peaks don't vanish
+            for (int bin = (int) startBin; bin <= (int) endBin; ++bin)
+                magnitude = juce::jmax (magnitude, magnitudes[(size_t) bin]);
+        }
+
+        const float level = juce::jlimit (minDecibels, maxDecibels,
+                                          juce::Decibels::gainToDecibels (magnitude * scale, minDecibels));
+        auto& displayed = analysis.levels[(size_t) band];
+        const float newLevel = juce::jmax (level, displayed - decay);
+
+        if (newLevel != displayed)
+        {
+            displayed = newLevel;
+            changed = true;
+        }
+    }
+
+    // Silence (or a signal below the floor) settles at minDecibels and stops here,
+    // so the editor's timer can go idle
+    return changed;
+}
+
+void SpectrumAnalyser::updateBandMapping (double sampleRate)
+{
+    const auto binWidth = (float) (sampleRate / fftSize);
+    const float lastBin = (float) (fftSize / 2 - 1);
+    const float frequencyRatio = maxFrequency / minFrequency;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        const float lowFrequency = minFrequency * std::pow (frequencyRatio, (float) band / numBands);
+        const float highFrequency = minFrequency * std::pow (frequencyRatio, (float) (band + 1) / numBands);
+
+        bandStartBin[(size_t) band] = juce::jmin (lowFrequency / binWidth, lastBin - 1.0f);
+        bandEndBin[(size_t) band] = juce::jmin (highFrequency / binWidth, lastBin);
+    }
+
+    mappedSampleRate = sampleRate;
+}
+
+//==============================================================================
+void SpectrumAnalyser::handleAsyncUpdate()
+{
+    if (onNewLevels != nullptr)
+        onNewLevels();
+}
+
+bool SpectrumAnalyser::refresh()
+{
+    if (! levelsChanged.exchange (false))
+        return false;
+
+    {
+        const juce::SpinLock::ScopedLockType lock (levelsLock);
+        displayInput = publishedInput;
+        displayOutput = publishedOutput;
+    }
+
+    repaint();
+    return true;
+}
+
+void SpectrumAnalyser::paint (juce::Graphics& g)
+{
+    const auto area = getLocalBounds().toFloat();
+
+    // Decade lines at 100Hz, 1kHz and 10kHz
+    g.setColour (juce::Colour (0x18ffffff));
+    for (float frequency : { 100.0f, 1000.0f, 10000.0f })
+        g.drawVerticalLine (juce::roundToInt (area.getX() + frequencyToX (frequency, area.getWidth())),
+                            area.getY(), area.getBottom());
+
+    // Input as a faint filled area, filter output as a line on top
+    g.setColour (juce::Colour (0x22ecf0f1));
+    g.fillPath (createSpectrumPath (displayInput, area, true));
+
+    g.setColour (juce::Colour (0xff4a90e2).withAlpha (0.7f));
+    g.strokePath (createSpectrumPath (displayOutput, area, false), juce::PathStrokeType (1.5f));
+}
+
+float SpectrumAnalyser::frequencyToX (float frequency, float width) const noexcept
+{
+    return width * std::log (frequency / minFrequency) / std::log (maxFrequency / minFrequency);
+}
+
+juce::Path SpectrumAnalyser::createSpectrumPath (const std::array<float, numBands>& levels,
+                                                 juce::Rectangle<float> area, bool closed) const
+{
+    juce::Path path;
+    const float width = area.getWidth();
+
+    if (width <= 0.0f)
+        return path;
+
+    if (closed)
+        path.startNewSubPath (area.getBottomLeft());
+
+    // One point every couple of pixels, read from the band under it; band centres
+    // sit half a band in from their edges
+    for (float x = 0.0f; x <= width; x += pixelsPerPoint)
+    {
+        const float position = juce::jlimit (0.0f, (float) (numBands - 1), x / width * numBands - 0.5f);
+        const int band = juce::jmin ((int) position, numBands - 2);
+        const float fraction = position - (float) band;
+        const float level = levels[(size_t) band] + fraction * (levels[(size_t) band + 1] - levels[(size_t) band]);
+
+        const juce::Point<float> point (area.getX() + x, juce::jmap (level, minDecibels, maxDecibels, area.getBottom(), area.getY()));
+
+        if (x == 0.0f && ! closed)
+            path.startNewSubPath (point);
+        else
+            path.lineTo (point);
+    }
+
+    if (closed)
+    {
+        path.lineTo (area.getBottomRight());
+        path.closeSubPath();
+    }
+
+    return path;
+}
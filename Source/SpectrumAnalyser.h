@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    Live pre/post-filter spectrum display drawn behind the editor's knobs.
+
+    The processor pushes audio into two AnalyserFifos; a background thread
+    pulls it, runs a windowed FFT of each channel every hop, averages their
+    power and bins the result onto a log-frequency axis. The message thread only copies the finished levels
+    and draws them, so neither the audio thread nor paint() does FFT work.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include "PluginProcessor.h"
+
+class SpectrumAnalyser : public juce::Component,
+                         private juce::Thread,
+                         private juce::AsyncUpdater
+{
+public:
+    SpectrumAnalyser (NewPluginSkeletonAudioProcessor&);
+    ~SpectrumAnalyser() override;
+
+    /** Call from the editor's timer: repaints and returns true if the analysis
+        thread has published levels that differ from the ones on screen.
+    */
+    bool refresh();
+
+    /** Called on the message thread when new levels arrive after the previous ones
+        were picked up by refresh(), so an idle editor timer can be restarted.
+    */
+    std::function<void()> onNewLevels;
+
+    void paint (juce::Graphics&) override;
+
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;   // 2048 points, ~23Hz resolution at 48kHz
+    static constexpr int hopSize = fftSize / 4;     // 75% overlap
+    static constexpr int numBands = 256;            // Log-spaced display bands, 20Hz - 20kHz
+
+    static constexpr float minFrequency = 20.0f, maxFrequency = 20000.0f;
+    static constexpr float minDecibels = -90.0f, maxDecibels = 6.0f;
+
+private:
+    /** One analysed signal (pre or post filter). Only touched by the analysis thread. */
+    struct Analysis
+    {
+        explicit Analysis (AnalyserFifo& source) : fifo (source) {}
+
+        AnalyserFifo& fifo;
+        std::array<std::array<float, fftSize>, AnalyserFifo::maxChannels> history {};  // Most recent fftSize samples
+        std::array<float, fftSize * 2> fftData {};
+        std::array<float, fftSize / 2 + 1> magnitudes {};   // Channels' RMS magnitude per bin
+        std::array<float, numBands> levels {};
+    };
+
+    void run() override;
+    void handleAsyncUpdate() override;
+    bool analyse (Analysis&);   // True if any band's level moved
+    void updateBandMapping (double sampleRate);
+
+    // Frequency to pixel x on the log axis
+    float frequencyToX (float frequency, float width) const noexcept;
+    juce::Path createSpectrumPath (const std::array<float, numBands>&, juce::Rectangle<float> area, bool closed) const;
+
+    NewPluginSkeletonAudioProcessor& processor;
+
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { (size_t) fftSize, juce::dsp::WindowingFunction<float>::hann, false };
+
+    Analysis input { processor.analyserInputFifo }, output { processor.analyserOutputFifo };
+
+    // FFT bin range for each band, rebuilt when the sample rate changes
+    std::array<float, numBands> bandStartBin {}, bandEndBin {};
+    double mappedSampleRate = 0.0;
+
+    // Hand-over to the message thread
+    juce::SpinLock levelsLock;
+    std::array<float, numBands> publishedInput {}, publishedOutput {};
+    std::atomic<bool> levelsChanged { false };
+
+    // Message thread copies used by paint()
+    std::array<float, numBands> displayInput {}, displayOutput {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumAnalyser)
+};
@@ -0,0 +1,178 @@
+/*
+  ==============================================================================
+
+    State variable filter building blocks used by the processor's filter chain.
+
+    The maths mirrors juce::dsp::StateVariableTPTFilter, but the coefficients
+    are computed separately from the per-channel state so they can be cached
+    and shared between all channels instead of being recomputed (with a tan()
+    each time) on every setter call. Which sections a slope runs, and at what
+    Q, comes from FilterDesign. The sections themselves are run by
+    SIMDFilterCascade.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <complex>
+#include "FilterKernels.h"
+#include "FilterDesign.h"
+
+//==============================================================================
+/**
+    Coefficients of one TPT state variable filter section, or of a one-pole
+    section (FilterKernels::onePoleSection), which only uses g and h.
+*/
+template <typename SampleType>
+struct SVFCoefficients
+{
+    SampleType g  = 0;  // tan (pi * cutoff / sampleRate)
+    SampleType R2 = 0;  // 1 / resonance
+    SampleType h  = 0;  // 1 / (1 + R2 * g + g * g), or g / (1 + g) for a one-pole section
+    int kind = FilterKernels::twoPoleSection;
+
+    bool operator== (const SVFCoefficients& other) const noexcept
+    {
+        return g == other.g && R2 == other.R2 && h == other.h && kind == other.kind;
+    }
+
+    bool operator!= (const SVFCoefficients& other) const noexcept   { return ! operator== (other); }
+};
+
+//==============================================================================
+/**
+    Computes and caches the coefficients of the filter chain.
+
+    The tan() prewarp only depends on the cutoff, so it is evaluated once per
+    distinct cutoff value, and nothing is recomputed at all while the cutoff,
+    resonance and layout stay where they are. Only the sections the layout
+    actually runs are computed. While the parameter smoothers are
+    ramping the processor calls update() once every updateInterval samples
+    rather than once per sample.
+*/
+template <typename SampleType, int maxStages>
+class SVFCoefficientEngine
+{
+public:
+    /** Number of samples between coefficient refreshes while parameters are smoothing. */
+    static constexpr int updateInterval = 16;
+
+    void prepare (double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        invalidate();
+    }
+
+    /** Forces the next call to update() to recompute everything. */
+    void invalidate() noexcept
+    {
+        lastCutoff = lastResonance = SampleType (-1);
+        lastLayout = nullptr;
+    }
+
+    /** Recomputes the coefficients of the layout's sections for the given settings
+        if they changed. Returns true if the coefficients are different from the
+        previous call. The layout must outlive the engine (the FilterDesign tables do).
+    */
+    bool update (SampleType cutoff, SampleType resonance, const FilterDesign::CascadeLayout& layout)
+    {
+        jassert (layout.numSections <= maxStages);
+
+        if (cutoff == lastCutoff && resonance == lastResonance && &layout == lastLayout)
+            return false;
+
+        if (cutoff != lastCutoff)
+        {
+            g = static_cast<SampleType> (std::tan (juce::MathConstants<double>::pi * cutoff / sampleRate));
+            lastCutoff = cutoff;
+        }
+
+        lastResonance = resonance;
+        lastLayout = &layout;
+
+        for (int section = 0; section < juce::jmin (layout.numSections, maxStages); ++section)
+        {
+            auto& c = stageCoefficients[(size_t) section];
+            c.g = g;
+            c.kind = layout.kinds[(size_t) section];
+
+            if (c.kind == FilterKernels::onePoleSection)
+            {
+                c.R2 = 0;
+                c.h  = static_cast<SampleType> (g / (1.0 + g));
+            }
+            else
+            {
+                c.R2 = static_cast<SampleType> (1.0 / layout.getSectionQ (section, resonance));
+                c.h  = static_cast<SampleType> (1.0 / (1.0 + c.R2 * c.g + c.g * c.g));
+            }
+        }
+
+        return true;
+    }
+
+    const SVFCoefficients<SampleType>& getStageCoefficients (int stage) const noexcept
+    {
+        return stageCoefficients[(size_t) stage];
+    }
+
+    const SVFCoefficients<SampleType>* getCoefficients() const noexcept
+    {
+        return stageCoefficients.data();
+    }
+
+private:
+    double sampleRate = 44100.0;
+    SampleType lastCutoff = SampleType (-1), lastResonance = SampleType (-1);
+    const FilterDesign::CascadeLayout* lastLayout = nullptr;
+    SampleType g = 0;
+    std::array<SVFCoefficients<SampleType>, (size_t) maxStages> stageCoefficients;
+};
+
+//==============================================================================
+/**
+    Frequency response of one section with the given coefficients.
+
+    The TPT SVF is the bilinear transform of the analog state variable filter,
+    with the cutoff prewarp folded into g, so evaluating the analog prototype at
+    s = j tan (pi * frequency / sampleRate) / g gives the exact digital response.
+    The same goes for the one-pole section.
+*/
+template <typename SampleType>
+std::complex<double> getSVFResponse (const SVFCoefficients<SampleType>& c,
+                                     juce::dsp::StateVariableTPTFilterType type,
+                                     double frequency, double sampleRate)
+{
+    const auto warped = std::tan (juce::MathConstants<double>::pi * juce::jmin (frequency, 0.4999 * sampleRate) / sampleRate);
+    const std::complex<double> s (0.0, warped / (double) c.g);
+
+    if (c.kind == FilterKernels::onePoleSection)
+        return type == juce::dsp::StateVariableTPTFilterType::highpass ? s / (s + 1.0) : 1.0 / (s + 1.0);
+
+    const auto denominator = s * s + (double) c.R2 * s + 1.0;
+
+    switch (type)
+    {
+        case juce::dsp::StateVariableTPTFilterType::highpass:  return s * s / denominator;
+        case juce::dsp::StateVariableTPTFilterType::bandpass:
+            return (c.kind == FilterKernels::unityPeakSection ? (double) c.R2 : 1.0) * s / denominator;
+        default:                                               return 1.0 / denominator;
+    }
+}
+
+/** Frequency response of the first numStages sections in series. */
+template <typename SampleType>
+std::complex<double> getCascadeResponse (const SVFCoefficients<SampleType>* stageCoefficients, int numStages,
+                                         juce::dsp::StateVariableTPTFilterType type,
+                                         double frequency, double sampleRate)
+{
+    std::complex<double> response (1.0, 0.0);
+
+    for (int stage = 0; stage < numStages; ++stage)
+        response *= getSVFResponse (stageCoefficients[stage], type, frequency, sampleRate);
+
+    return response;
+}
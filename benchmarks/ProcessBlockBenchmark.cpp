@@ -0,0 +1,315 @@
+/*
+  ==============================================================================
+
+    processBlock benchmark suite.
+
+    Measures NewPluginSkeletonAudioProcessor::processBlock in nanoseconds per
+    sample across every slope and filter type, block sizes from 16 to 4096,
+    mono/stereo/8 channels, static and automated parameters, and sample rates
+    from 44.1 kHz to 192 kHz. Results are written as JSON in the same shape as
+    Google Benchmark's output, so existing tooling can compare runs.
+
+    Usage:
+        MyAwesomePlugin_Bench [--filter <text>] [--repetitions <n>] [--out <file.json>]
+
+  ==============================================================================
+*/
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    struct BenchmarkCase
+    {
+        int slopeIndex = 0, typeIndex = 0;
+        int blockSize = 512, numChannels = 2;
+        double sampleRate = 48000.0;
+        bool automated = false;
+
+        juce::String name;
+    };
+
+    struct BenchmarkOptions
+    {
+        juce::String filter;
+        int repetitions = 5;
+        int samplesPerRepetition = 1 << 17;  // Per channel, enough to swamp timer overhead
+        juce::File outputFile;
+    };
+
+    void setParameter(NewPluginSkeletonAudioProcessor& processor, const juce::String& parameterID, float value)
+    {
+        // setValue() followed by the listener callback, the way the plugin wrappers deliver
+        // host automation; the processor only sees changes through its listeners
+        if (auto* parameter = processor.parameters.getParameter(parameterID))
+        {
+            const auto normalised = processor.parameters.getParameterRange(parameterID).convertTo0to1(value);
+            parameter->setValue(normalised);
+            parameter->sendValueChangedMessageToListeners(normalised);
+        }
+    }
+
+    /** True if what the processor's listeners saw matches the case's settings. */
+    bool hasSettings(NewPluginSkeletonAudioProcessor& processor, const ParameterSnapshot& listened, const BenchmarkCase& c)
+    {
+        ParameterSnapshot::Values values;
+
+        if (! listened.read(values))
+            return false;
+
+        const auto get = [&](const juce::String& parameterID) { return values.get(processor.parameters.getParameter(parameterID), -1.0f); };
+
+        return juce::roundToInt(get("filterSlope")) == c.slopeIndex
+            && juce::roundToInt(get("filterType")) == c.typeIndex
+            && std::abs(get("cutoff") - 1000.0f) < 1.0f;
+    }
+
+    juce::StringArray getChoices(NewPluginSkeletonAudioProcessor& processor, const juce::String& parameterID)
+    {
+        if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(processor.parameters.getParameter(parameterID)))
+            return choice->choices;
+
+        return {};
+    }
+
+    juce::Array<BenchmarkCase> createCases(const BenchmarkOptions& options)
+    {
+        NewPluginSkeletonAudioProcessor processor;
+        const auto slopes = getChoices(processor, "filterSlope");
+        const auto types = getChoices(processor, "filterType");
+
+        juce::Array<BenchmarkCase> cases;
+
+        for (double sampleRate : { 44100.0, 48000.0, 96000.0, 192000.0 })
+        for (int numChannels : { 1, 2, 8 })
+        for (int blockSize : { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 })
+        for (bool automated : { false, true })
+        for (int slopeIndex = 0; slopeIndex < slopes.size(); ++slopeIndex)
+        for (int typeIndex = 0; typeIndex < types.size(); ++typeIndex)
+        {
+            BenchmarkCase c;
+            c.slopeIndex = slopeIndex;
+            c.typeIndex = typeIndex;
+            c.blockSize = blockSize;
+            c.numChannels = numChannels;
+            c.sampleRate = sampleRate;
+            c.automated = automated;
+            c.name = "processBlock/slope:" + slopes[slopeIndex].removeCharacters(" ")
+                   + "/type:" + types[typeIndex]
+                   + "/block:" + juce::String(blockSize)
+                   + "/channels:" + juce::String(numChannels)
+                   + "/rate:" + juce::String(juce::roundToInt(sampleRate))
+                   + "/params:" + (automated ? "automated" : "static");
+
+            if (options.filter.isEmpty() || c.name.containsIgnoreCase(options.filter))
+                cases.add(c);
+        }
+
+        return cases;
+    }
+
+    /** Runs one case and returns the nanoseconds per sample of each repetition, or
+        nothing if the processor didn't pick up the case's settings.
+    */
+    juce::Array<double> runCase(const BenchmarkCase& c, const BenchmarkOptions& options)
+    {
+        NewPluginSkeletonAudioProcessor processor;
+
+        // Listens the same way the processor does, to check the settings reach it
+        ParameterSnapshot listened;
+        listened.attach(processor.getParameters());
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(c.numChannels));
+        layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(c.numChannels));
+        processor.setBusesLayout(layout);
+
+        setParameter(processor, "filterSlope", static_cast<float>(c.slopeIndex));
+        setParameter(processor, "filterType", static_cast<float>(c.typeIndex));
+        setParameter(processor, "cutoff", 1000.0f);
+        setParameter(processor, "resonance", 0.707f);
+
+        if (! hasSettings(processor, listened, c))
+            return {};
+
+        processor.setRateAndBufferSizeDetails(c.sampleRate, c.blockSize);
+        processor.prepareToPlay(c.sampleRate, c.blockSize);
+
+        // -12 dBFS white noise keeps the limiter out of the way
+        juce::AudioBuffer<float> source(c.numChannels, c.blockSize);
+        juce::Random random(0x5eed);
+
+        for (int ch = 0; ch < c.numChannels; ++ch)
+            for (int i = 0; i < c.blockSize; ++i)
+                source.setSample(ch, i, 0.25f * (random.nextFloat() * 2.0f - 1.0f));
+
+        juce::AudioBuffer<float> buffer(c.numChannels, c.blockSize);
+        juce::MidiBuffer midiBuffer;
+
+        const int numBlocks = juce::jmax(1, options.samplesPerRepetition / c.blockSize);
+        int blockCounter = 0;
+
+        auto processBlocks = [&](int count)
+        {
+            for (int block = 0; block < count; ++block, ++blockCounter)
+            {
+                // Automation moves cutoff and resonance every block, so the smoothers
+                // never settle and the coefficients are always being refreshed
+                if (c.automated)
+                {
+                    const auto phase = static_cast<float>(blockCounter) * 0.05f;
+                    setParameter(processor, "cutoff", 1000.0f * std::pow(4.0f, std::sin(phase)));
+                    setParameter(processor, "resonance", 1.0f + 0.5f * std::sin(phase * 1.3f));
+                }
+
+                for (int ch = 0; ch < c.numChannels; ++ch)
+                    buffer.copyFrom(ch, 0, source, ch, 0, c.blockSize);
+
+                processor.processBlock(buffer, midiBuffer);
+            }
+        };
+
+        // Warm up caches, branch predictors and the smoothers
+        const auto staticVersion = listened.getVersion();
+        processBlocks(juce::jmax(1, numBlocks / 8));
+
+        if (c.automated && listened.getVersion() == staticVersion)
+            return {};
+
+        juce::Array<double> nanosecondsPerSample;
+
+        for (int repetition = 0; repetition < options.repetitions; ++repetition)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            processBlocks(numBlocks);
+            const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+            const auto totalSamples = static_cast<double>(numBlocks) * c.blockSize * c.numChannels;
+            nanosecondsPerSample.add(elapsed * 1.0e9 / totalSamples);
+        }
+
+        processor.releaseResources();
+        return nanosecondsPerSample;
+    }
+
+    juce::var createResult(const BenchmarkCase& c, const BenchmarkOptions& options, juce::Array<double> timings)
+    {
+        std::sort(timings.begin(), timings.end());
+
+        const auto median = timings[timings.size() / 2];
+        const auto numBlocks = juce::jmax(1, options.samplesPerRepetition / c.blockSize);
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty("name", c.name);
+        result->setProperty("run_type", "aggregate");
+        result->setProperty("aggregate_name", "median");
+        result->setProperty("repetitions", options.repetitions);
+        result->setProperty("iterations", numBlocks);
+        result->setProperty("real_time", median * c.blockSize * c.numChannels);  // Per processBlock call
+        result->setProperty("time_unit", "ns");
+        result->setProperty("ns_per_sample", median);
+        result->setProperty("ns_per_sample_min", timings.getFirst());
+        result->setProperty("ns_per_sample_max", timings.getLast());
+        result->setProperty("realtime_ratio", 1.0e9 / (median * c.numChannels * c.sampleRate));
+        result->setProperty("slope", c.slopeIndex);
+        result->setProperty("type", c.typeIndex);
+        result->setProperty("block_size", c.blockSize);
+        result->setProperty("channels", c.numChannels);
+        result->setProperty("sample_rate", c.sampleRate);
+        result->setProperty("automated", c.automated);
+        return juce::var(result);
+    }
+
+    juce::var createContext()
+    {
+        auto* context = new juce::DynamicObject();
+        context->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+        context->setProperty("host_name", juce::SystemStats::getComputerName());
+        context->setProperty("cpu_vendor", juce::SystemStats::getCpuVendor());
+        context->setProperty("cpu_model", juce::SystemStats::getCpuModel());
+        context->setProperty("num_cpus", juce::SystemStats::getNumCpus());
+        context->setProperty("mhz_per_cpu", juce::SystemStats::getCpuSpeedInMegahertz());
+        context->setProperty("has_avx2", juce::SystemStats::hasAVX2());
+        context->setProperty("plugin_version", JucePlugin_VersionString);
+       #if JUCE_DEBUG
+        context->setProperty("library_build_type", "debug");
+       #else
+        context->setProperty("library_build_type", "release");
+       #endif
+        return juce::var(context);
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    BenchmarkOptions options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg(juce::CharPointer_UTF8(argv[i]));
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--filter" && hasValue)
+            options.filter = juce::CharPointer_UTF8(argv[++i]);
+        else if (arg == "--repetitions" && hasValue)
+            options.repetitions = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--out" && hasValue)
+            options.outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(juce::CharPointer_UTF8(argv[++i]));
+        else
+        {
+            std::cerr << "Usage: MyAwesomePlugin_Bench [--filter <text>] [--repetitions <n>] [--out <file.json>]\n";
+            return 1;
+        }
+    }
+
+    const auto cases = createCases(options);
+    juce::Array<juce::var> benchmarks;
+
+    for (int i = 0; i < cases.size(); ++i)
+    {
+        const auto& c = cases.getReference(i);
+        const auto timings = runCase(c, options);
+
+        if (timings.isEmpty())
+        {
+            std::cerr << c.name << ": the processor didn't pick up the benchmark's parameter settings\n";
+            return 1;
+        }
+
+        auto result = createResult(c, options, timings);
+
+        // Progress goes to stderr so stdout stays valid JSON
+        std::cerr << "[" << (i + 1) << "/" << cases.size() << "] " << c.name << "  "
+                  << juce::String(static_cast<double>(result["ns_per_sample"]), 3) << " ns/sample\n";
+
+        benchmarks.add(result);
+    }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("context", createContext());
+    root->setProperty("benchmarks", benchmarks);
+
+    const auto json = juce::JSON::toString(juce::var(root));
+
+    if (options.outputFile != juce::File())
+    {
+        if (! options.outputFile.replaceWithText(json))
+        {
+            std::cerr << "Couldn't write " << options.outputFile.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << json << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+
+// Helpers shared by the unit tests
+namespace TestHelpers
+{
+    // Sets a parameter from its raw (unnormalised) value the way the host or the editor
+    // does, so the parameter listeners and the processor's snapshot pick it up
+    inline void setParameter(NewPluginSkeletonAudioProcessor& processor, const juce::String& parameterID, float rawValue)
+    {
+        if (auto* parameter = processor.parameters.getParameter(parameterID))
+            parameter->setValueNotifyingHost(processor.parameters.getParameterRange(parameterID).convertTo0to1(rawValue));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/AnalyserFifo.h"
+#include "../Source/PluginProcessor.h"
+#include <cmath>
+
+class AnalyserFifoTest : public juce::UnitTest
+{
+public:
+    AnalyserFifoTest() : juce::UnitTest("Analyser FIFO Test") {}
+    
+    void runTest() override
+    {
+        beginTest("Each channel is read back in order");
+        {
+            AnalyserFifo fifo;
+            juce::AudioBuffer<float> buffer(2, 32);
+            
+            for (int block = 0; block < 3; ++block)
+            {
+                for (int i = 0; i < 32; ++i)
+                {
+                    buffer.setSample(0, i, static_cast<float>(block * 32 + i));
+                    buffer.setSample(1, i, static_cast<float>(block * 32 + i) + 2.0f);
+                }
+                
+                fifo.push(buffer, 2);
+            }
+            
+            expectEquals(fifo.getNumReady(), 96, "Every pushed sample should be readable");
+            expectEquals(fifo.getNumChannels(), 2);
+            
+            juce::AudioBuffer<float> samples(2, 96);
+            expectEquals(fifo.pull(samples.getArrayOfWritePointers(), 2, 96), 96);
+            
+            bool inOrder = true;
+            for (int i = 0; i < 96; ++i)
+                inOrder = inOrder && samples.getSample(0, i) == static_cast<float>(i)
+                                  && samples.getSample(1, i) == static_cast<float>(i) + 2.0f;
+            
+            expect(inOrder, "Samples should be each channel's own, in order");
+        }
+        
+        beginTest("Out of phase channels don't cancel");
+        {
+            // A pure side signal, which a mono mixdown would turn into silence
+            AnalyserFifo fifo;
+            juce::AudioBuffer<float> buffer(2, 64);
+            
+            for (int i = 0; i < 64; ++i)
+            {
+                const float sample = std::sin(0.1f * static_cast<float>(i));
+                buffer.setSample(0, i, sample);
+                buffer.setSample(1, i, -sample);
+            }
+            
+            fifo.push(buffer, 2);
+            
+            juce::AudioBuffer<float> samples(2, 64);
+            fifo.pull(samples.getArrayOfWritePointers(), 2, 64);
+            
+            expectWithinAbsoluteError(samples.getRMSLevel(0, 0, 64), buffer.getRMSLevel(0, 0, 64), 1.0e-6f);
+            expectWithinAbsoluteError(samples.getRMSLevel(1, 0, 64), buffer.getRMSLevel(1, 0, 64), 1.0e-6f);
+        }
+        
+        beginTest("Channels missing from a push read as silence");
+        {
+            AnalyserFifo fifo;
+            juce::AudioBuffer<float> stereo(2, 16), mono(1, 16);
+            
+            for (int i = 0; i < 16; ++i)
+            {
+                stereo.setSample(0, i, 1.0f);
+                stereo.setSample(1, i, 1.0f);
+                mono.setSample(0, i, 0.5f);
+            }
+            
+            fifo.push(stereo, 2);
+            fifo.push(mono, 1);
+            expectEquals(fifo.getNumChannels(), 2, "The channel count shouldn't shrink");
+            
+            juce::AudioBuffer<float> samples(2, 32);
+            expectEquals(fifo.pull(samples.getArrayOfWritePointers(), 2, 32), 32);
+            expectEquals(samples.getSample(1, 8), 1.0f);
+            expectEquals(samples.getSample(0, 24), 0.5f);
+            expectEquals(samples.getSample(1, 24), 0.0f, "The second channel wasn't pushed, so it should be silent");
+        }
+        
+        beginTest("A full FIFO drops samples instead of waiting");
+        {
+            AnalyserFifo fifo;
+            juce::AudioBuffer<float> buffer(1, 4096);
+            buffer.clear();
+            
+            for (int block = 0; block < 10; ++block)
+                fifo.push(buffer, 1);
+            
+            expect(fifo.getNumReady() < AnalyserFifo::capacity, "FIFO should never overfill");
+            expectEquals(fifo.getNumReady() + fifo.getNumDroppedSamples(), 10 * 4096,
+                         "Every sample should be either queued or counted as dropped");
+        }
+        
+        beginTest("Processor feeds the analyser only while it's enabled");
+        {
+            NewPluginSkeletonAudioProcessor processor;
+            processor.setRateAndBufferSizeDetails(48000.0, 32);
+            processor.prepareToPlay(48000.0, 32);
+            
+            juce::AudioBuffer<float> buffer(2, 32);
+            juce::MidiBuffer midiBuffer;
+            buffer.clear();
+            
+            processor.processBlock(buffer, midiBuffer);
+            expectEquals(processor.analyserOutputFifo.getNumReady(), 0, "Nothing should be pushed while disabled");
+            
+            processor.analyserEnabled.store(true);
+            processor.processBlock(buffer, midiBuffer);
+            expectEquals(processor.analyserInputFifo.getNumReady(), 32, "Input side should get the block");
+            expectEquals(processor.analyserOutputFifo.getNumReady(), 32, "Output side should get the block");
+        }
+    }
+};
+
+static AnalyserFifoTest analyserFifoTest;
\ No newline at end of file
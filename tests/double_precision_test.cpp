@@ -0,0 +1,95 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_dsp/juce_dsp.h>
+#include "../Source/PluginProcessor.h"
+#include "TestHelpers.h"
+#include <cmath>
+
+class DoublePrecisionTest : public juce::UnitTest
+{
+public:
+    DoublePrecisionTest() : juce::UnitTest("Double Precision Test") {}
+    
+    void runTest() override
+    {
+        beginTest("Double precision processing matches single precision");
+        {
+            NewPluginSkeletonAudioProcessor floatProcessor, doubleProcessor;
+            expect(doubleProcessor.supportsDoublePrecisionProcessing());
+            
+            doubleProcessor.setProcessingPrecision(juce::AudioProcessor::doublePrecision);
+            
+            for (auto* processor : { &floatProcessor, &doubleProcessor })
+            {
+                TestHelpers::setParameter(*processor, "filterSlope", 3.0f);    // 24 dB/oct
+                TestHelpers::setParameter(*processor, "cutoff", 1000.0f);
+                prepare(*processor);
+            }
+            
+            expect(doubleProcessor.isUsingDoublePrecision());
+            
+            // A tone an octave above the cutoff, after the filter has settled
+            const auto floatOutput = processTone<float>(floatProcessor, 2000.0);
+            const auto doubleOutput = processTone<double>(doubleProcessor, 2000.0);
+            
+            expectWithinAbsoluteError(doubleOutput, floatOutput, 0.05, "Same response in both precisions (dB)");
+            expectWithinAbsoluteError(doubleOutput, -24.2, 0.5, "24 dB/oct an octave above the cutoff");
+        }
+        
+        beginTest("Low cutoffs at high sample rates stay on target in double precision");
+        {
+            NewPluginSkeletonAudioProcessor processor;
+            processor.setProcessingPrecision(juce::AudioProcessor::doublePrecision);
+            
+            TestHelpers::setParameter(processor, "filterSlope", 1.0f);     // 12 dB/oct
+            TestHelpers::setParameter(processor, "cutoff", 20.0f);
+            prepare(processor, 192000.0);
+            
+            // -3 dB at the cutoff, even though the coefficients are tiny at this rate
+            expectWithinAbsoluteError(processTone<double>(processor, 20.0, 192000.0), -3.01, 0.1);
+        }
+    }
+    
+private:
+    static constexpr int blockSize = 512;
+    
+    void prepare(NewPluginSkeletonAudioProcessor& processor, double sampleRate = 48000.0)
+    {
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+    }
+    
+    // Level of a sine through the processor, in dB, measured over its last second
+    template <typename SampleType>
+    double processTone(NewPluginSkeletonAudioProcessor& processor, double frequency, double sampleRate = 48000.0)
+    {
+        juce::AudioBuffer<SampleType> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        
+        const int totalBlocks = static_cast<int>(std::ceil(3.0 * sampleRate / blockSize));
+        const int measuredBlocks = static_cast<int>(std::ceil(sampleRate / blockSize));
+        double sumSquares = 0.0;
+        juce::int64 position = 0;
+        
+        for (int block = 0; block < totalBlocks; ++block)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const auto sample = static_cast<SampleType>(0.5 * std::sin(juce::MathConstants<double>::twoPi * frequency
+                                                                           * static_cast<double>(position++) / sampleRate));
+                buffer.setSample(0, i, sample);
+                buffer.setSample(1, i, sample);
+            }
+            
+            processor.processBlock(buffer, midi);
+            
+            if (block >= totalBlocks - measuredBlocks)
+                for (int i = 0; i < blockSize; ++i)
+                    sumSquares += static_cast<double>(buffer.getSample(0, i)) * static_cast<double>(buffer.getSample(0, i));
+        }
+        
+        const double rms = std::sqrt(sumSquares / (measuredBlocks * blockSize));
+        return juce::Decibels::gainToDecibels(rms / (0.5 / std::sqrt(2.0)), -300.0);
+    }
+};
+
+static DoublePrecisionTest doublePrecisionTest;
\ No newline at end of file
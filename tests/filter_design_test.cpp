@@ -0,0 +1,151 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_dsp/juce_dsp.h>
+#include "../Source/PluginProcessor.h"
+#include <cmath>
+
+class FilterDesignTest : public juce::UnitTest
+{
+public:
+    FilterDesignTest() : juce::UnitTest("Filter Design Test") {}
+    
+    void runTest() override
+    {
+        const double sampleRate = 48000.0;
+        const double cutoff = 1000.0;
+        
+        beginTest("Every slope runs exactly the sections its order needs");
+        {
+            for (int slopeIndex = 0; slopeIndex < FilterDesign::numSlopes; ++slopeIndex)
+            {
+                const int order = FilterDesign::slopeDecibelsPerOctave[static_cast<size_t>(slopeIndex)] / 6;
+                const auto& layout = FilterDesign::getLayout(slopeIndex, FilterDesign::butterworth, false);
+                
+                expectEquals(layout.numSections, (order + 1) / 2);
+                expect((layout.kinds[0] == FilterKernels::onePoleSection) == (order % 2 == 1),
+                       "Odd orders should start with a one-pole section");
+                expectEquals(FilterDesign::getLayout(slopeIndex, FilterDesign::butterworth, true).numSections, order,
+                             "Bandpass runs one section per 6 dB/oct");
+            }
+        }
+        
+        beginTest("Butterworth layouts are maximally flat");
+        {
+            for (int slopeIndex = 0; slopeIndex < FilterDesign::numSlopes; ++slopeIndex)
+            {
+                const int order = FilterDesign::slopeDecibelsPerOctave[static_cast<size_t>(slopeIndex)] / 6;
+                
+                for (double frequency : { 250.0, 1000.0, 2000.0, 4000.0 })
+                {
+                    // Butterworth magnitude at the prewarped frequency, which the bilinear transform gives exactly
+                    const double ratio = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate)
+                                       / std::tan(juce::MathConstants<double>::pi * cutoff / sampleRate);
+                    const double expected = -10.0 * std::log10(1.0 + std::pow(ratio, 2.0 * order));
+                    
+                    expectWithinAbsoluteError(getResponseDecibels(slopeIndex, FilterDesign::butterworth, frequency),
+                                              expected, 0.01,
+                                              "Order " + juce::String(order) + " at " + juce::String(frequency) + " Hz");
+                }
+            }
+        }
+        
+        beginTest("Linkwitz-Riley layouts are -6 dB at the cutoff");
+        {
+            for (int slopeIndex : { 1, 3, 4, 5 })
+                expectWithinAbsoluteError(getResponseDecibels(slopeIndex, FilterDesign::linkwitzRiley, cutoff),
+                                          -6.02, 0.01);
+            
+            // Odd orders have no Linkwitz-Riley form
+            expectWithinAbsoluteError(getResponseDecibels(2, FilterDesign::linkwitzRiley, cutoff), -3.01, 0.01);
+        }
+        
+        beginTest("Bandpass gain at the centre doesn't build up with the slope");
+        {
+            for (int slopeIndex = 0; slopeIndex < FilterDesign::numSlopes; ++slopeIndex)
+            {
+                const auto& layout = FilterDesign::getLayout(slopeIndex, FilterDesign::butterworth, true);
+                SVFCoefficientEngine<double, FilterDesign::maxSections> engine;
+                engine.prepare(sampleRate);
+                engine.update(cutoff, 4.0, layout);
+                
+                const auto magnitude = std::abs(getCascadeResponse(engine.getCoefficients(), layout.numSections,
+                                                                   juce::dsp::StateVariableTPTFilterType::bandpass,
+                                                                   cutoff, sampleRate));
+                expectWithinAbsoluteError(magnitude, 4.0, 1.0e-6, "Only the last section's resonant peak should remain");
+            }
+        }
+        
+        beginTest("Compiled cascades match running the sections one at a time");
+        {
+            using Register = juce::dsp::SIMDRegister<float>;
+            constexpr int width = static_cast<int>(Register::size());
+            constexpr int numFrames = 256;
+            
+            for (int layoutId = 0; layoutId < FilterDesign::numLayouts; ++layoutId)
+            {
+                const auto& layout = FilterDesign::getLayoutById(layoutId);
+                expectEquals(layout.id, FilterDesign::getLayoutById(layout.id).id);
+                
+                // Every lane runs its own cutoff and resonance
+                std::array<SVFCoefficientEngine<float, FilterDesign::maxSections>, width> engines;
+                for (int lane = 0; lane < width; ++lane)
+                {
+                    engines[static_cast<size_t>(lane)].prepare(sampleRate);
+                    engines[static_cast<size_t>(lane)].update(static_cast<float>(cutoff * (lane + 1)), 2.0f - 0.25f * static_cast<float>(lane), layout);
+                }
+                
+                for (int type = 0; type < 3; ++type)
+                {
+                    alignas(64) float compiled[numFrames * width], reference[numFrames * width];
+                    alignas(64) float compiledState[FilterDesign::maxSections * 2 * width] {};
+                    alignas(64) float referenceState[FilterDesign::maxSections * 2 * width] {};
+                    alignas(64) float coefficients[FilterDesign::maxSections * 3 * width];
+                    
+                    for (int i = 0; i < numFrames * width; ++i)
+                        compiled[i] = reference[i] = std::sin(static_cast<float>(i) * 0.37f) + static_cast<float>(i % 13) * 0.05f;
+                    
+                    for (int stage = 0; stage < layout.numSections; ++stage)
+                    {
+                        auto* stageCoefficients = coefficients + stage * 3 * width;
+                        
+                        for (int lane = 0; lane < width; ++lane)
+                        {
+                            const auto& c = engines[static_cast<size_t>(lane)].getCoefficients()[stage];
+                            stageCoefficients[lane] = c.g;
+                            stageCoefficients[width + lane] = c.R2;
+                            stageCoefficients[2 * width + lane] = c.h;
+                        }
+                        
+                        auto* s1 = referenceState + stage * 2 * width;
+                        FilterKernels::processStage<Register, float>(reference, numFrames, s1, s1 + width, stageCoefficients,
+                                                                     FilterKernels::getStageType(layout.kinds[static_cast<size_t>(stage)], type));
+                    }
+                    
+                    FilterDesign::getCascadeKernel<Register, float>(layoutId, type)(compiled, numFrames, compiledState, coefficients);
+                    
+                    float worst = 0.0f;
+                    for (int i = 0; i < numFrames * width; ++i)
+                        worst = juce::jmax(worst, std::abs(compiled[i] - reference[i]));
+                    for (int i = 0; i < FilterDesign::maxSections * 2 * width; ++i)
+                        worst = juce::jmax(worst, std::abs(compiledState[i] - referenceState[i]));
+                    
+                    expectEquals(worst, 0.0f, "Layout " + juce::String(layoutId) + ", type " + juce::String(type));
+                }
+            }
+        }
+    }
+    
+private:
+    static double getResponseDecibels(int slopeIndex, int alignment, double frequency)
+    {
+        const auto& layout = FilterDesign::getLayout(slopeIndex, alignment, false);
+        SVFCoefficientEngine<double, FilterDesign::maxSections> engine;
+        engine.prepare(48000.0);
+        engine.update(1000.0, FilterDesign::neutralResonance, layout);
+        
+        const auto response = getCascadeResponse(engine.getCoefficients(), layout.numSections,
+                                                  juce::dsp::StateVariableTPTFilterType::lowpass, frequency, 48000.0);
+        return juce::Decibels::gainToDecibels(std::abs(response), -300.0);
+    }
+};
+
+static FilterDesignTest filterDesignTest;
\ No newline at end of file
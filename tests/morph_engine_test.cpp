@@ -0,0 +1,167 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include "../Source/MorphEngine.h"
+#include "TestHelpers.h"
+#include <cmath>
+
+class MorphEngineTest : public juce::UnitTest
+{
+public:
+    MorphEngineTest() : juce::UnitTest("Morph Engine Test") {}
+    
+    void runTest() override
+    {
+        beginTest("Snapshots are reproduced at the corners and blended in between");
+        {
+            MorphEngine engine;
+            const juce::NormalisableRange<float> cutoffRange(20.0f, 20000.0f, 1.0f, 0.3f);
+            engine.addTarget({ "cutoff", cutoffRange, 1000.0f, false });
+            engine.addTarget({ "slope", juce::NormalisableRange<float>(0.0f, 2.0f, 1.0f), 0.0f, true });
+            
+            engine.update();
+            expect(! engine.isActive(), "No snapshots, no morph");
+            
+            engine.setSnapshot(0, makeValues(200.0f, 0.0f));
+            engine.update();
+            expect(! engine.isActive(), "A alone isn't enough to morph");
+            
+            engine.setSnapshot(1, makeValues(8000.0f, 2.0f));
+            expect(engine.update(), "A new table should be picked up");
+            expect(! engine.update(), "...but only once");
+            expect(engine.isActive());
+            
+            float values[MorphEngine::maxTargets];
+            
+            engine.getValues(0.0f, 0.0f, values);
+            expectWithinAbsoluteError(values[0], 200.0f, 0.5f);
+            expectEquals(values[1], 0.0f);
+            
+            engine.getValues(1.0f, 0.0f, values);
+            expectWithinAbsoluteError(values[0], 8000.0f, 1.0f);
+            expectEquals(values[1], 2.0f);
+            
+            // Continuous targets blend the way their knob moves
+            const auto halfway = cutoffRange.convertFrom0to1(0.5f * (cutoffRange.convertTo0to1(200.0f) + cutoffRange.convertTo0to1(8000.0f)));
+            engine.getValues(0.5f, 0.0f, values);
+            expectWithinAbsoluteError(values[0], halfway, halfway * 0.01f);
+            
+            // Stepped targets jump at the midpoint
+            engine.getValues(0.45f, 0.0f, values);
+            expectEquals(values[1], 0.0f);
+            engine.getValues(0.55f, 0.0f, values);
+            expectEquals(values[1], 2.0f);
+            
+            // Without C and D, the Y axis changes nothing
+            engine.getValues(0.25f, 1.0f, values);
+            float bottom[MorphEngine::maxTargets];
+            engine.getValues(0.25f, 0.0f, bottom);
+            expectWithinAbsoluteError(values[0], bottom[0], 0.01f);
+            
+            engine.setSnapshot(2, makeValues(50.0f, 1.0f));
+            engine.setSnapshot(3, makeValues(15000.0f, 1.0f));
+            engine.update();
+            engine.getValues(1.0f, 1.0f, values);
+            expectWithinAbsoluteError(values[0], 15000.0f, 1.0f, "D sits at the top right of the XY pad");
+            expectEquals(values[1], 1.0f);
+            
+            // Other threads get the same values without the audio thread's table
+            float latest[MorphEngine::maxTargets];
+            engine.getValues(0.3f, 0.7f, values);
+            expect(engine.getLatestValues(0.3f, 0.7f, latest));
+            expectWithinAbsoluteError(latest[0], values[0], 0.01f);
+            expectEquals(latest[1], values[1]);
+            
+            engine.clearSnapshots();
+            engine.update();
+            expect(! engine.isActive(), "Clearing the slots turns the morph off");
+            expect(! engine.getLatestValues(0.3f, 0.7f, latest));
+        }
+        
+        beginTest("The morph parameter drives the filter");
+        {
+            juce::NamedValueSet dark, bright;
+            dark.set("cutoff", 200.0f);
+            dark.set("filterType", 0.0f);
+            bright.set("cutoff", 5000.0f);
+            bright.set("filterType", 0.0f);
+            
+            // Morphed all the way to the bright snapshot...
+            NewPluginSkeletonAudioProcessor morphed;
+            morphed.setMorphSnapshot(0, dark);
+            morphed.setMorphSnapshot(1, bright);
+            TestHelpers::setParameter(morphed, "morph", 1.0f);
+            expectWithinAbsoluteError(morphed.getFilterSettings().cutoff, 5000.0f, 1.0f);
+            
+            // ...should sound like the bright settings dialled in directly
+            NewPluginSkeletonAudioProcessor direct;
+            TestHelpers::setParameter(direct, "cutoff", 5000.0f);
+            
+            const auto morphedRms = processNoise(morphed);
+            const auto directRms = processNoise(direct);
+            expectWithinAbsoluteError(morphedRms, directRms, directRms * 0.01f);
+            
+            morphed.clearMorphSnapshots();
+            expect(! morphed.hasMorphSnapshot(0));
+        }
+        
+        beginTest("Morph snapshots are saved with the session");
+        {
+            NewPluginSkeletonAudioProcessor source;
+            source.setMorphSnapshot(0, makeValues(200.0f, 0.0f));
+            source.setMorphSnapshot(1, makeValues(5000.0f, 3.0f));
+            source.setMorphSnapshot(3, makeValues(12000.0f, 1.0f));
+            TestHelpers::setParameter(source, "morph", 0.75f);
+            
+            juce::MemoryBlock state;
+            source.getStateInformation(state);
+            
+            NewPluginSkeletonAudioProcessor restored;
+            restored.setMorphSnapshot(2, makeValues(1000.0f, 0.0f));
+            restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            
+            expect(restored.hasMorphSnapshot(0) && restored.hasMorphSnapshot(1) && restored.hasMorphSnapshot(3));
+            expect(! restored.hasMorphSnapshot(2), "Loading a session replaces every slot");
+            expectWithinAbsoluteError(processNoise(restored), processNoise(source), 1.0e-6f, "The reopened session morphs the same way");
+            
+            // A session saved without snapshots turns the morph off
+            NewPluginSkeletonAudioProcessor plain;
+            plain.getStateInformation(state);
+            restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            expect(! restored.hasMorphSnapshot(0));
+        }
+    }
+    
+private:
+    static juce::NamedValueSet makeValues(float cutoff, float slope)
+    {
+        juce::NamedValueSet values;
+        values.set("cutoff", cutoff);
+        values.set("slope", slope);
+        return values;
+    }
+    
+    static float processNoise(NewPluginSkeletonAudioProcessor& processor)
+    {
+        constexpr int blockSize = 512;
+        processor.setRateAndBufferSizeDetails(48000.0, blockSize);
+        processor.prepareToPlay(48000.0, blockSize);
+        
+        juce::Random random(0x5eed);
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midiBuffer;
+        
+        for (int block = 0; block < 32; ++block)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample(ch, i, 0.1f * (random.nextFloat() * 2.0f - 1.0f));
+            
+            processor.processBlock(buffer, midiBuffer);
+        }
+        
+        processor.releaseResources();
+        return buffer.getRMSLevel(0, 0, blockSize);
+    }
+};
+
+static MorphEngineTest morphEngineTest;
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_dsp/juce_dsp.h>
+#include "../Source/PluginProcessor.h"
+#include <cmath>
+
+class MultichannelLayoutTest : public juce::UnitTest
+{
+public:
+    MultichannelLayoutTest() : juce::UnitTest("Multichannel Layout Test") {}
+    
+    void runTest() override
+    {
+        beginTest("Surround, immersive and ambisonic layouts are supported");
+        
+        NewPluginSkeletonAudioProcessor processor;
+        
+        expect(processor.checkBusesLayoutSupported(makeLayout(juce::AudioChannelSet::mono())), "Mono should be supported");
+        expect(processor.checkBusesLayoutSupported(makeLayout(juce::AudioChannelSet::stereo())), "Stereo should be supported");
+        expect(processor.checkBusesLayoutSupported(makeLayout(juce::AudioChannelSet::create5point1())), "5.1 should be supported");
+        expect(processor.checkBusesLayoutSupported(makeLayout(juce::AudioChannelSet::create7point1point4())), "7.1.4 should be supported");
+        expect(processor.checkBusesLayoutSupported(makeLayout(juce::AudioChannelSet::ambisonic(3))), "3rd order ambisonics should be supported");
+        expect(processor.checkBusesLayoutSupported(makeLayout(juce::AudioChannelSet::discreteChannels(11))), "Discrete layouts should be supported");
+        
+        // Input and output must still match
+        juce::AudioProcessor::BusesLayout mismatched;
+        mismatched.inputBuses.add(juce::AudioChannelSet::stereo());
+        mismatched.outputBuses.add(juce::AudioChannelSet::create5point1());
+        expect(! processor.checkBusesLayoutSupported(mismatched), "Mismatched input and output should be rejected");
+        
+        beginTest("Every channel of a 7.1.4 bed is filtered identically");
+        
+        const auto layout = makeLayout(juce::AudioChannelSet::create7point1point4());
+        expect(processor.setBusesLayout(layout), "7.1.4 layout should be applied");
+        
+        double sampleRate = 48000.0;
+        int bufferSize = 512;
+        processor.setRateAndBufferSizeDetails(sampleRate, bufferSize);
+        processor.prepareToPlay(sampleRate, bufferSize);
+        
+        const int numChannels = processor.getTotalNumOutputChannels();
+        expectEquals(numChannels, 12, "7.1.4 should have 12 channels");
+        
+        // Set filter to 24dB/oct slope at 1kHz
+        auto* slopeParam = processor.parameters.getParameter("filterSlope");
+        if (slopeParam)
+        {
+            slopeParam->setValueNotifyingHost(slopeParam->convertTo0to1(3.0f)); // 24dB
+        }
+        
+        auto* cutoffParam = processor.parameters.getParameter("cutoff");
+        if (cutoffParam)
+        {
+            cutoffParam->setValueNotifyingHost(processor.parameters.getParameterRange("cutoff")
+                .convertTo0to1(1000.0f));
+        }
+        
+        // Same signal on every channel, so every channel must come out the same
+        juce::AudioBuffer<float> testBuffer(numChannels, bufferSize);
+        juce::MidiBuffer midiBuffer;
+        
+        for (int blockIndex = 0; blockIndex < 20; ++blockIndex)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                for (int i = 0; i < bufferSize; ++i)
+                {
+                    float phase = (2.0f * juce::MathConstants<float>::pi * 440.0f * (blockIndex * bufferSize + i)) / sampleRate;
+                    testBuffer.setSample(ch, i, 0.5f * std::sin(phase));
+                }
+            }
+            
+            processor.processBlock(testBuffer, midiBuffer);
+        }
+        
+        float maxDifference = 0.0f;
+        for (int ch = 1; ch < numChannels; ++ch)
+        {
+            for (int i = 0; i < bufferSize; ++i)
+            {
+                maxDifference = juce::jmax(maxDifference, std::abs(testBuffer.getSample(ch, i) - testBuffer.getSample(0, i)));
+            }
+        }
+        
+        expect(maxDifference < 1.0e-6f,
+               "Channels differ by " + juce::String(maxDifference) + " for identical input");
+        expect(testBuffer.getMagnitude(0, 0, bufferSize) > 0.1f, "A 440Hz tone should pass a 1kHz low-pass");
+    }
+    
+private:
+    static juce::AudioProcessor::BusesLayout makeLayout(const juce::AudioChannelSet& channelSet)
+    {
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(channelSet);
+        layout.outputBuses.add(channelSet);
+        return layout;
+    }
+};
+
+static MultichannelLayoutTest multichannelLayoutTest;
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_dsp/juce_dsp.h>
+#include "../Source/PluginProcessor.h"
+#include "TestHelpers.h"
+#include <cmath>
+
+class OutputLimiterTest : public juce::UnitTest
+{
+public:
+    OutputLimiterTest() : juce::UnitTest("Output Limiter Test") {}
+    
+    void runTest() override
+    {
+        const float threshold = juce::Decibels::decibelsToGain(-0.1f);
+        
+        for (bool truePeak : { false, true })
+        {
+            for (float lookaheadMs : { 0.0f, 2.0f })
+            {
+                beginTest("Output stays below -0.1dB (true peak: " + juce::String(truePeak ? "on" : "off")
+                          + ", lookahead: " + juce::String(lookaheadMs) + "ms)");
+                
+                NewPluginSkeletonAudioProcessor processor;
+                TestHelpers::setParameter(processor, "truePeak", truePeak ? 1.0f : 0.0f);
+                TestHelpers::setParameter(processor, "lookahead", lookaheadMs);
+                TestHelpers::setParameter(processor, "gain", 12.0f);
+                TestHelpers::setParameter(processor, "cutoff", 20000.0f);
+                
+                double sampleRate = 48000.0;
+                int bufferSize = 512;
+                processor.setRateAndBufferSizeDetails(sampleRate, bufferSize);
+                processor.prepareToPlay(sampleRate, bufferSize);
+                
+                // Lookahead and true-peak detection are reported to the host as latency
+                const int latency = processor.getLatencySamples();
+                if (lookaheadMs > 0.0f || truePeak)
+                    expect(latency > 0, "Lookahead and true peak should add latency");
+                else
+                    expectEquals(latency, 0, "Sample-peak limiting without lookahead should add no latency");
+                
+                juce::AudioBuffer<float> testBuffer(2, bufferSize);
+                juce::MidiBuffer midiBuffer;
+                float maxOutput = 0.0f;
+                
+                for (int blockIndex = 0; blockIndex < 40; ++blockIndex)
+                {
+                    for (int ch = 0; ch < 2; ++ch)
+                    {
+                        for (int i = 0; i < bufferSize; ++i)
+                        {
+                            float phase = (2.0f * juce::MathConstants<float>::pi * 1000.0f * (blockIndex * bufferSize + i)) / sampleRate;
+                            testBuffer.setSample(ch, i, 0.9f * std::sin(phase));
+                        }
+                    }
+                    
+                    processor.processBlock(testBuffer, midiBuffer);
+                    maxOutput = juce::jmax(maxOutput, testBuffer.getMagnitude(0, bufferSize));
+                }
+                
+                expect(maxOutput <= threshold + 1.0e-6f,
+                       "Output peaked at " + juce::String(juce::Decibels::gainToDecibels(maxOutput)) + "dB");
+                expect(maxOutput > 0.9f, "Limited signal should sit just under the threshold");
+            }
+        }
+        
+        beginTest("Quiet signals pass the limiter untouched");
+        
+        NewPluginSkeletonAudioProcessor processor;
+        TestHelpers::setParameter(processor, "cutoff", 20000.0f);
+        
+        double sampleRate = 48000.0;
+        int bufferSize = 512;
+        processor.setRateAndBufferSizeDetails(sampleRate, bufferSize);
+        processor.prepareToPlay(sampleRate, bufferSize);
+        
+        juce::AudioBuffer<float> testBuffer(2, bufferSize);
+        juce::MidiBuffer midiBuffer;
+        
+        // A 20kHz 6dB/oct low-pass barely touches a 100Hz tone, so the level stays at -12dB
+        float maxOutput = 0.0f;
+        for (int blockIndex = 0; blockIndex < 20; ++blockIndex)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                for (int i = 0; i < bufferSize; ++i)
+                {
+                    float phase = (2.0f * juce::MathConstants<float>::pi * 100.0f * (blockIndex * bufferSize + i)) / sampleRate;
+                    testBuffer.setSample(ch, i, 0.25f * std::sin(phase));
+                }
+            }
+            
+            processor.processBlock(testBuffer, midiBuffer);
+            maxOutput = juce::jmax(maxOutput, testBuffer.getMagnitude(0, bufferSize));
+        }
+        
+        expectWithinAbsoluteError(maxOutput, 0.25f, 0.01f, "Signal below the threshold should not be reduced");
+    }
+};
+
+static OutputLimiterTest outputLimiterTest;
\ No newline at end of file
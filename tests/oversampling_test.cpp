@@ -0,0 +1,171 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_dsp/juce_dsp.h>
+#include "../Source/PluginProcessor.h"
+#include "TestHelpers.h"
+#include <cmath>
+#include <vector>
+
+class OversamplingTest : public juce::UnitTest
+{
+public:
+    OversamplingTest() : juce::UnitTest("Oversampling Test") {}
+    
+    void runTest() override
+    {
+        double sampleRate = 48000.0;
+        int bufferSize = 512;
+        
+        beginTest("Oversampling latency is reported");
+        {
+            NewPluginSkeletonAudioProcessor processor;
+            processor.setRateAndBufferSizeDetails(sampleRate, bufferSize);
+            processor.prepareToPlay(sampleRate, bufferSize);
+            expectEquals(processor.getLatencySamples(), 0, "Oversampling off should add no latency");
+            
+            TestHelpers::setParameter(processor, "oversampling", 2.0f);        // 4x
+            TestHelpers::setParameter(processor, "oversamplingFilter", 1.0f);  // Linear phase FIR
+            processor.prepareToPlay(sampleRate, bufferSize);
+            expect(processor.getLatencySamples() > 0, "Linear phase oversampling should report latency");
+        }
+        
+        beginTest("Auto oversampling keeps the latency constant");
+        {
+            NewPluginSkeletonAudioProcessor processor;
+            TestHelpers::setParameter(processor, "oversampling", 4.0f);  // Auto
+            TestHelpers::setParameter(processor, "cutoff", 200.0f);
+            processor.setRateAndBufferSizeDetails(sampleRate, bufferSize);
+            processor.prepareToPlay(sampleRate, bufferSize);
+            
+            const int lowCutoffLatency = processor.getLatencySamples();
+            expect(lowCutoffLatency > 0, "Auto mode should report its highest factor's latency");
+            
+            // A high cutoff makes auto mode step up to a higher factor
+            TestHelpers::setParameter(processor, "cutoff", 18000.0f);
+            processBlocks(processor, 20, 1000.0f, sampleRate, bufferSize);
+            expect(processor.getFilterSampleRate() > sampleRate, "Auto mode should have stepped up");
+            expectEquals(processor.getLatencySamples(), lowCutoffLatency, "Latency shouldn't change with the factor");
+        }
+        
+        beginTest("Oversampling keeps the response accurate near Nyquist");
+        {
+            // A 12 dB/oct Butterworth lowpass at 10kHz is 10.6dB down at 18kHz. At 1x the
+            // bilinear transform squeezes that towards Nyquist (about 20dB down); 4x and 8x
+            // should be close to the analog response.
+            const float analogDecibels = -10.6f;
+            
+            for (float choice : { 0.0f, 2.0f, 3.0f })
+            {
+                NewPluginSkeletonAudioProcessor processor;
+                TestHelpers::setParameter(processor, "oversampling", choice);
+                TestHelpers::setParameter(processor, "filterSlope", 1.0f);   // 12 dB/oct
+                TestHelpers::setParameter(processor, "cutoff", 10000.0f);
+                processor.setRateAndBufferSizeDetails(sampleRate, bufferSize);
+                processor.prepareToPlay(sampleRate, bufferSize);
+                
+                const float rms = processBlocks(processor, 20, 18000.0f, sampleRate, bufferSize);
+                const float error = std::abs(juce::Decibels::gainToDecibels(rms / (0.25f / std::sqrt(2.0f))) - analogDecibels);
+                
+                if (choice == 0.0f)
+                    expect(error > 5.0f, "1x should be well off the analog response");
+                else
+                    expectWithinAbsoluteError(error, 0.0f, 1.5f, "18kHz level at oversampling choice " + juce::String(choice));
+            }
+        }
+        
+        beginTest("Switching factor leaves no gap");
+        {
+            // Small blocks, so a switch spans many of them
+            const int smallBlockSize = 32;
+            NewPluginSkeletonAudioProcessor processor;
+            TestHelpers::setParameter(processor, "oversampling", 4.0f);  // Auto
+            TestHelpers::setParameter(processor, "cutoff", 5000.0f);
+            processor.setRateAndBufferSizeDetails(sampleRate, smallBlockSize);
+            processor.prepareToPlay(sampleRate, smallBlockSize);
+            
+            // A 500Hz sine passes a 5kHz lowpass and an 18kHz one alike, so only the
+            // switch itself could change the level
+            const float frequency = 500.0f;
+            const int period = juce::roundToInt(sampleRate / frequency);
+            juce::AudioBuffer<float> testBuffer(2, smallBlockSize);
+            juce::MidiBuffer midiBuffer;
+            std::vector<float> output;
+            
+            for (int blockIndex = 0; blockIndex < 1500; ++blockIndex)
+            {
+                if (blockIndex == 300)
+                    TestHelpers::setParameter(processor, "cutoff", 18000.0f);
+                
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < smallBlockSize; ++i)
+                        testBuffer.setSample(ch, i, 0.25f * std::sin(2.0f * juce::MathConstants<float>::pi * frequency
+                                                                     * static_cast<float>(blockIndex * smallBlockSize + i)
+                                                                     / static_cast<float>(sampleRate)));
+                
+                processor.processBlock(testBuffer, midiBuffer);
+                output.insert(output.end(), testBuffer.getReadPointer(0), testBuffer.getReadPointer(0) + smallBlockSize);
+            }
+            
+            expect(processor.getFilterSampleRate() > sampleRate, "Auto mode should have switched factor");
+            
+            // Every period after the start-up latency still peaks at (close to) the input level
+            float quietestPeak = 1.0f;
+            for (size_t start = static_cast<size_t>(100 * smallBlockSize); start + static_cast<size_t>(period) <= output.size();
+                 start += static_cast<size_t>(period))
+            {
+                float peak = 0.0f;
+                for (size_t i = start; i < start + static_cast<size_t>(period); ++i)
+                    peak = juce::jmax(peak, std::abs(output[i]));
+                
+                quietestPeak = juce::jmin(quietestPeak, peak);
+            }
+            
+            expect(quietestPeak > 0.2f, "The output dipped to " + juce::String(quietestPeak) + " during the switch");
+        }
+        
+        beginTest("Oversampled filter passes the passband");
+        {
+            for (float choice : { 1.0f, 2.0f, 3.0f })
+            {
+                NewPluginSkeletonAudioProcessor processor;
+                TestHelpers::setParameter(processor, "oversampling", choice);
+                TestHelpers::setParameter(processor, "cutoff", 20000.0f);
+                processor.setRateAndBufferSizeDetails(sampleRate, bufferSize);
+                processor.prepareToPlay(sampleRate, bufferSize);
+                
+                // 1kHz at 0.25 is far below a 20kHz lowpass, so it should come out unchanged
+                const float rms = processBlocks(processor, 20, 1000.0f, sampleRate, bufferSize);
+                const float expectedRms = 0.25f / std::sqrt(2.0f);
+                
+                expectWithinAbsoluteError(juce::Decibels::gainToDecibels(rms / expectedRms), 0.0f, 0.5f,
+                                          "Passband level at oversampling choice " + juce::String(choice));
+            }
+        }
+    }
+    
+private:
+    // Processes a -12dB sine and returns the RMS of the last block
+    static float processBlocks(NewPluginSkeletonAudioProcessor& processor, int numBlocks, float frequency,
+                               double sampleRate, int bufferSize)
+    {
+        juce::AudioBuffer<float> testBuffer(2, bufferSize);
+        juce::MidiBuffer midiBuffer;
+        
+        for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                for (int i = 0; i < bufferSize; ++i)
+                {
+                    float phase = (2.0f * juce::MathConstants<float>::pi * frequency * (blockIndex * bufferSize + i)) / sampleRate;
+                    testBuffer.setSample(ch, i, 0.25f * std::sin(phase));
+                }
+            }
+            
+            processor.processBlock(testBuffer, midiBuffer);
+        }
+        
+        return testBuffer.getRMSLevel(0, 0, bufferSize);
+    }
+};
+
+static OversamplingTest oversamplingTest;
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include "TestHelpers.h"
+#include <cmath>
+#include <thread>
+
+class ParameterSnapshotTest : public juce::UnitTest
+{
+public:
+    ParameterSnapshotTest() : juce::UnitTest("Parameter Snapshot Test") {}
+    
+    void runTest() override
+    {
+        beginTest("Version only moves when a parameter changes");
+        {
+            NewPluginSkeletonAudioProcessor processor;
+            ParameterSnapshot snapshot;
+            snapshot.attach(processor.getParameters());
+            
+            const auto initial = snapshot.getVersion();
+            expectEquals(snapshot.getVersion(), initial, "Nothing changed, so the version shouldn't either");
+            
+            TestHelpers::setParameter(processor, "cutoff", 2500.0f);
+            expect(snapshot.getVersion() != initial, "A parameter change should move the version");
+        }
+        
+        beginTest("Read values match the parameters");
+        {
+            NewPluginSkeletonAudioProcessor processor;
+            ParameterSnapshot snapshot;
+            snapshot.attach(processor.getParameters());
+            
+            TestHelpers::setParameter(processor, "cutoff", 440.0f);
+            TestHelpers::setParameter(processor, "resonance", 2.5f);
+            TestHelpers::setParameter(processor, "filterSlope", 2.0f);
+            
+            ParameterSnapshot::Values values;
+            expect(snapshot.read(values), "Nothing is being published, so the read should succeed");
+            
+            expectEquals(values.version, snapshot.getVersion());
+            expectWithinAbsoluteError(values.get(getRanged(processor, "cutoff"), 0.0f), 440.0f, 1.0e-2f);
+            expectWithinAbsoluteError(values.get(getRanged(processor, "resonance"), 0.0f), 2.5f, 1.0e-4f);
+            expectEquals(values.get(getRanged(processor, "filterSlope"), 0.0f), 2.0f);
+            expectEquals(values.get(nullptr, -1.0f), -1.0f, "Missing parameters fall back");
+        }
+        
+        beginTest("A batch is published as a single write");
+        {
+            NewPluginSkeletonAudioProcessor processor;
+            ParameterSnapshot snapshot;
+            snapshot.attach(processor.getParameters());
+            
+            const auto before = snapshot.getVersion();
+            
+            {
+                const ParameterSnapshot::ScopedBatch batch(snapshot);
+                TestHelpers::setParameter(processor, "cutoff", 5000.0f);
+                TestHelpers::setParameter(processor, "gain", -6.0f);
+                
+                expectEquals(snapshot.getVersion(), before, "Nothing is published until the batch ends");
+                
+                // Other threads' single changes (e.g. automation on the audio thread) don't
+                // wait for the batch; if they did, this would never finish
+                const auto lookahead = processor.parameters.getParameterRange("lookahead").convertTo0to1(2.0f);
+                std::thread automation([&processor, lookahead] { processor.parameters.getParameter("lookahead")->setValueNotifyingHost(lookahead); });
+                automation.join();
+                
+                ParameterSnapshot::Values during;
+                expect(snapshot.read(during));
+                expectWithinAbsoluteError(during.get(getRanged(processor, "lookahead"), 0.0f), 2.0f, 1.0e-4f);
+                expect(during.get(getRanged(processor, "cutoff"), 0.0f) != 5000.0f, "The batch's changes are still staged");
+            }
+            
+            expect(snapshot.getVersion() > before, "Publishing the batch should move the version");
+            
+            ParameterSnapshot::Values values;
+            expect(snapshot.read(values));
+            expectWithinAbsoluteError(values.get(getRanged(processor, "cutoff"), 0.0f), 5000.0f, 1.0e-1f);
+            expectWithinAbsoluteError(values.get(getRanged(processor, "gain"), 0.0f), -6.0f, 1.0e-4f);
+        }
+        
+        beginTest("Loading state doesn't disturb processing");
+        {
+            NewPluginSkeletonAudioProcessor source;
+            TestHelpers::setParameter(source, "cutoff", 300.0f);
+            TestHelpers::setParameter(source, "filterType", 1.0f);
+            
+            juce::MemoryBlock state;
+            source.getStateInformation(state);
+            
+            NewPluginSkeletonAudioProcessor processor;
+            processor.prepareToPlay(48000.0, 256);
+            processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            
+            juce::AudioBuffer<float> buffer(2, 256);
+            juce::MidiBuffer midiBuffer;
+            
+            for (int block = 0; block < 8; ++block)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < 256; ++i)
+                        buffer.setSample(ch, i, 0.25f * std::sin(0.05f * static_cast<float>(block * 256 + i)));
+                
+                processor.processBlock(buffer, midiBuffer);
+                
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < 256; ++i)
+                        expect(std::isfinite(buffer.getSample(ch, i)), "Output should stay finite");
+            }
+            
+            processor.releaseResources();
+        }
+    }
+    
+private:
+    static const juce::RangedAudioParameter* getRanged(NewPluginSkeletonAudioProcessor& processor, const juce::String& parameterID)
+    {
+        return processor.parameters.getParameter(parameterID);
+    }
+};
+
+static ParameterSnapshotTest parameterSnapshotTest;
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_dsp/juce_dsp.h>
+#include "../Source/PluginProcessor.h"
+#include <cmath>
+
+class PerformanceCountersTest : public juce::UnitTest
+{
+public:
+    PerformanceCountersTest() : juce::UnitTest("Performance Counters Test") {}
+    
+    void runTest() override
+    {
+        beginTest("Block timings are published");
+        
+        NewPluginSkeletonAudioProcessor processor;
+        
+        double sampleRate = 48000.0;
+        int bufferSize = 512;
+        processor.setRateAndBufferSizeDetails(sampleRate, bufferSize);
+        processor.prepareToPlay(sampleRate, bufferSize);
+        
+        expectEquals((int) processor.getPerformanceCounters().getSnapshot().numBlocks, 0,
+                     "prepareToPlay should clear the counters");
+        
+        processBlocks(processor, 10, 0.25f, sampleRate, bufferSize);
+        
+        auto snapshot = processor.getPerformanceCounters().getSnapshot();
+        expectEquals((int) snapshot.numBlocks, 10, "Every block should be counted");
+        expect(snapshot.lastBlockSeconds > 0.0, "Block time should be measured");
+        expect(snapshot.worstBlockSeconds >= snapshot.lastBlockSeconds, "Worst case should cover the last block");
+        expect(snapshot.budgetRatio > 0.0, "Budget ratio should be measured");
+        expectEquals(snapshot.smoothingPercent, 0.0, "Nothing should have been smoothing");
+        expectEquals(snapshot.limitingPercent, 0.0, "A -12dB signal shouldn't be limited");
+        
+        beginTest("Smoothing and limiting activity are reported");
+        
+        // Cutoff change ramps for 50ms, and +12dB on a 0.9 sine needs limiting
+        auto* cutoffParam = processor.parameters.getParameter("cutoff");
+        cutoffParam->setValueNotifyingHost(processor.parameters.getParameterRange("cutoff").convertTo0to1(5000.0f));
+        auto* gainParam = processor.parameters.getParameter("gain");
+        gainParam->setValueNotifyingHost(processor.parameters.getParameterRange("gain").convertTo0to1(12.0f));
+        
+        processBlocks(processor, 10, 0.9f, sampleRate, bufferSize);
+        
+        snapshot = processor.getPerformanceCounters().getSnapshot();
+        expect(snapshot.smoothingPercent > 0.0 && snapshot.smoothingPercent < 100.0,
+               "Smoothing share was " + juce::String(snapshot.smoothingPercent) + "%");
+        expect(snapshot.limitingPercent > 0.0, "Limiter activity should be reported");
+        expect(snapshot.limiterGainReductionDb < 0.0f, "Gain reduction should be negative");
+        
+        beginTest("Worst case can be reset");
+        
+        processor.resetWorstCasePerformance();
+        snapshot = processor.getPerformanceCounters().getSnapshot();
+        expectEquals(snapshot.worstBlockSeconds, 0.0, "Worst block time should be cleared");
+        expectEquals((int) snapshot.numBlocks, 20, "Reset should only clear the worst case");
+    }
+    
+private:
+    static void processBlocks(NewPluginSkeletonAudioProcessor& processor, int numBlocks, float amplitude,
+                              double sampleRate, int bufferSize)
+    {
+        juce::AudioBuffer<float> testBuffer(2, bufferSize);
+        juce::MidiBuffer midiBuffer;
+        
+        for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                for (int i = 0; i < bufferSize; ++i)
+                {
+                    float phase = (2.0f * juce::MathConstants<float>::pi * 440.0f * (blockIndex * bufferSize + i)) / sampleRate;
+                    testBuffer.setSample(ch, i, amplitude * std::sin(phase));
+                }
+            }
+            
+            processor.processBlock(testBuffer, midiBuffer);
+        }
+    }
+};
+
+static PerformanceCountersTest performanceCountersTest;
\ No newline at end of file
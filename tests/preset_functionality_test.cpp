@@ -25,7 +25,7 @@ public:
         auto* cutoffParam = processor.parameters.getParameter("cutoff");
         auto* resonanceParam = processor.parameters.getParameter("resonance");
         auto* gainParam = processor.parameters.getParameter("gain");
-        auto* slopeParam = processor.parameters.getParameter("slope");
+        auto* slopeParam = processor.parameters.getParameter("filterSlope");
         auto* filterTypeParam = processor.parameters.getParameter("filterType");
         
         expect(cutoffParam != nullptr, "Cutoff parameter should exist");
@@ -38,7 +38,7 @@ public:
         cutoffParam->setValueNotifyingHost(0.5f);  // Mid-range cutoff
         resonanceParam->setValueNotifyingHost(0.8f); // High resonance
         gainParam->setValueNotifyingHost(0.3f);    // Some gain
-        slopeParam->setValueNotifyingHost(0.5f);   // 12dB slope
+        slopeParam->setValueNotifyingHost(0.2f);   // 12dB slope
         filterTypeParam->setValueNotifyingHost(0.5f); // High pass
         
         // Test parameter state saving and loading
@@ -68,7 +68,7 @@ public:
         expectWithinAbsoluteError(cutoffParam->getValue(), 0.5f, 0.01f, "Cutoff should be restored");
         expectWithinAbsoluteError(resonanceParam->getValue(), 0.8f, 0.01f, "Resonance should be restored");
         expectWithinAbsoluteError(gainParam->getValue(), 0.3f, 0.01f, "Gain should be restored");
-        expectWithinAbsoluteError(slopeParam->getValue(), 0.5f, 0.01f, "Slope should be restored");
+        expectWithinAbsoluteError(slopeParam->getValue(), 0.2f, 0.01f, "Slope should be restored");
         expectWithinAbsoluteError(filterTypeParam->getValue(), 0.5f, 0.01f, "Filter type should be restored");
         
         logMessage("All parameters correctly saved and restored from preset data");
@@ -0,0 +1,140 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include "../Source/PresetIndex.h"
+#include "TestHelpers.h"
+#include <algorithm>
+
+class PresetIndexTest : public juce::UnitTest
+{
+public:
+    PresetIndexTest() : juce::UnitTest("Preset Index Test") {}
+    
+    void runTest() override
+    {
+        const auto root = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                              .getNonexistentChildFile("PresetIndexTest", "");
+        const auto directory = root.getChildFile("Presets");
+        const auto cacheFile = root.getChildFile("PresetIndex.cache");
+        
+        writePreset(directory.getChildFile("Warm Bass.xml"), 300.0f, 0, 3);
+        writePreset(directory.getChildFile("Air Lift.xml"), 8000.0f, 1, 1);
+        writePreset(directory.getChildFile("Drums/Snare Band.xml"), 2000.0f, 2, 0);
+        directory.getChildFile("Broken.xml").replaceWithText("not a preset");
+        
+        beginTest("Scanning finds every preset");
+        {
+            PresetIndex index(directory, cacheFile, false);
+            expect(index.scan(), "The first scan should fill the index");
+            
+            const auto entries = index.getEntries();
+            expectEquals(static_cast<int>(entries->size()), 3, "The unreadable file should be skipped");
+            expectEquals(entries->front()->name, juce::String("Air Lift"), "Entries should be sorted by name");
+            
+            const auto snare = index.search({ "snare" });
+            expectEquals(static_cast<int>(snare.size()), 1);
+            expect(snare.front()->tags.contains("Drums"), "Sub-folders should become tags");
+            expectEquals(snare.front()->filterType, 2);
+            expectWithinAbsoluteError(static_cast<float>(snare.front()->values["cutoff"]), 2000.0f, 0.5f);
+            
+            expect(! index.scan(), "Nothing changed, so a rescan shouldn't either");
+        }
+        
+        beginTest("Search ranks prefix matches first and supports fuzzy and filtered queries");
+        {
+            PresetIndex index(directory, cacheFile, false);
+            index.scan();
+            
+            const auto byTag = index.search({ "dru" });
+            expectEquals(static_cast<int>(byTag.size()), 1, "Tags should be searchable");
+            
+            const auto fuzzy = index.search({ "wrmbs" });
+            expect(fuzzy.size() == 1 && fuzzy.front()->name == "Warm Bass", "Subsequences should match");
+            
+            expect(index.search({ "zzz" }).empty());
+            
+            const juce::StringArray types { "Low-pass", "High-pass", "Band-pass" };
+            const juce::StringArray slopes { "6 dB/oct", "12 dB/oct", "18 dB/oct", "24 dB/oct", "36 dB/oct", "48 dB/oct" };
+            const auto query = PresetIndex::Query::parse("type:high a", types, slopes);
+            expectEquals(query.filterType, 1);
+            expectEquals(query.text, juce::String("a"));
+            
+            const auto highPass = index.search(query);
+            expect(highPass.size() == 1 && highPass.front()->name == "Air Lift", "Only high-pass presets should match");
+            
+            const auto slope24 = index.search(PresetIndex::Query::parse("slope:24", types, slopes));
+            expect(slope24.size() == 1 && slope24.front()->name == "Warm Bass");
+        }
+        
+        beginTest("The cache is reused and only changed files are read again");
+        {
+            PresetIndex index(directory, cacheFile, false);
+            index.scan();
+            const auto before = index.getEntries();
+            
+            // Make sure the modification time moves
+            const auto airLift = directory.getChildFile("Air Lift.xml");
+            writePreset(airLift, 9000.0f, 1, 1);
+            airLift.setLastModificationTime(juce::Time::getCurrentTime() + juce::RelativeTime::seconds(10.0));
+            directory.getChildFile("Warm Bass.xml").deleteFile();
+            
+            expect(index.scan(), "A changed and a deleted preset should be picked up");
+            const auto after = index.getEntries();
+            expectEquals(static_cast<int>(after->size()), 2);
+            
+            const auto unchanged = index.search({ "snare" }).front();
+            expect(std::find(before->begin(), before->end(), unchanged) != before->end(),
+                   "Unchanged presets should keep their entry rather than being parsed again");
+            
+            expectWithinAbsoluteError(static_cast<float>(index.search({ "air" }).front()->values["cutoff"]), 9000.0f, 0.5f);
+        }
+        
+        beginTest("Presets from before the slope choices changed keep their slope");
+        {
+            // Version 1 presets had no version attribute and slopes 6, 12 and 24 dB/oct,
+            // saved as "slope"
+            auto xml = juce::parseXML(directory.getChildFile("Drums/Snare Band.xml"));
+            xml->removeAttribute("version");
+            xml->removeChildElement(xml->getChildByAttribute("id", "filterSlope"), true);
+            
+            for (auto* parameter : xml->getChildWithTagNameIterator("PARAM"))
+                if (parameter->getStringAttribute("id") == "slope")
+                    parameter->setAttribute("value", 2);
+            
+            const auto legacyFile = root.getChildFile("Legacy.xml");
+            xml->writeTo(legacyFile);
+            
+            const auto legacy = PresetIndex::readPresetFile(legacyFile, directory);
+            expect(legacy != nullptr);
+            expectEquals(legacy->slope, 3, "24 dB/oct should still be 24 dB/oct");
+        }
+        
+        beginTest("Loading a preset from the index sets the parameters");
+        {
+            PresetIndex index(directory, cacheFile, false);
+            index.scan();
+            
+            NewPluginSkeletonAudioProcessor processor;
+            processor.setParameterValues(index.search({ "snare" }).front()->values);
+            
+            expectWithinAbsoluteError(processor.parameters.getRawParameterValue("cutoff")->load(), 2000.0f, 0.5f);
+            expectEquals(processor.parameters.getRawParameterValue("filterType")->load(), 2.0f);
+        }
+        
+        root.deleteRecursively();
+    }
+    
+private:
+    static void writePreset(const juce::File& file, float cutoff, int filterType, int slope)
+    {
+        // Same format as the editor's Save button
+        NewPluginSkeletonAudioProcessor processor;
+        TestHelpers::setParameter(processor, "cutoff", cutoff);
+        TestHelpers::setParameter(processor, "filterType", static_cast<float>(filterType));
+        TestHelpers::setParameter(processor, "filterSlope", static_cast<float>(slope));
+        
+        file.getParentDirectory().createDirectory();
+        processor.parameters.copyState().createXml()->writeTo(file);
+    }
+};
+
+static PresetIndexTest presetIndexTest;
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_dsp/juce_dsp.h>
+#include "../Source/PluginProcessor.h"
+#include "TestHelpers.h"
+#include <cmath>
+
+class ResponseCurveTest : public juce::UnitTest
+{
+public:
+    ResponseCurveTest() : juce::UnitTest("Response Curve Test") {}
+    
+    void runTest() override
+    {
+        beginTest("Analytic response matches the processed signal");
+        
+        const double sampleRate = 48000.0;
+        const int bufferSize = 512;
+        const float cutoff = 1000.0f;
+        
+        NewPluginSkeletonAudioProcessor reference;
+        const int numSlopes = dynamic_cast<juce::AudioParameterChoice*>(reference.parameters.getParameter("filterSlope"))->choices.size();
+        
+        for (int slopeIndex = 0; slopeIndex < numSlopes; ++slopeIndex)
+        {
+            for (int typeIndex = 0; typeIndex < 3; ++typeIndex)
+            {
+                for (int alignment : { FilterDesign::butterworth, FilterDesign::linkwitzRiley })
+                {
+                    for (float frequency : { 281.25f, 1968.75f })  // Whole cycles per block, so the RMS is exact
+                    {
+                        NewPluginSkeletonAudioProcessor processor;
+                        processor.setPlayConfigDetails(2, 2, sampleRate, bufferSize);
+                        TestHelpers::setParameter(processor, "filterSlope", static_cast<float>(slopeIndex));
+                        TestHelpers::setParameter(processor, "filterType", static_cast<float>(typeIndex));
+                        TestHelpers::setParameter(processor, "alignment", static_cast<float>(alignment));
+                        TestHelpers::setParameter(processor, "cutoff", cutoff);
+                        TestHelpers::setParameter(processor, "resonance", 0.707f);
+                        processor.prepareToPlay(sampleRate, bufferSize);
+                        
+                        const float measured = measureGainDecibels(processor, frequency, sampleRate, bufferSize);
+                        
+                        // What the editor draws for these settings
+                        const auto& layout = FilterDesign::getLayout(slopeIndex, alignment, typeIndex == 2);
+                        SVFCoefficientEngine<double, FilterDesign::maxSections> engine;
+                        engine.prepare(processor.getFilterSampleRate());
+                        engine.update(cutoff, 0.707, layout);
+                        
+                        const auto type = typeIndex == 1 ? juce::dsp::StateVariableTPTFilterType::highpass
+                                        : typeIndex == 2 ? juce::dsp::StateVariableTPTFilterType::bandpass
+                                                         : juce::dsp::StateVariableTPTFilterType::lowpass;
+                        const auto magnitude = std::abs(getCascadeResponse(engine.getCoefficients(), layout.numSections, type,
+                                                                           frequency, processor.getFilterSampleRate()));
+                        const auto expected = static_cast<float>(juce::Decibels::gainToDecibels(magnitude));
+                        
+                        expectWithinAbsoluteError(measured, expected, 0.5f,
+                                                  "Slope " + juce::String(slopeIndex) + ", type " + juce::String(typeIndex)
+                                                  + ", alignment " + juce::String(alignment)
+                                                  + " at " + juce::String(frequency) + " Hz");
+                    }
+                }
+            }
+        }
+    }
+    
+private:
+    // Gain of a -20dB sine once the filter has settled, from the last block's RMS
+    static float measureGainDecibels(NewPluginSkeletonAudioProcessor& processor, float frequency,
+                                     double sampleRate, int bufferSize)
+    {
+        juce::AudioBuffer<float> testBuffer(2, bufferSize);
+        juce::MidiBuffer midiBuffer;
+        const float amplitude = 0.1f;
+        
+        for (int blockIndex = 0; blockIndex < 40; ++blockIndex)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                for (int i = 0; i < bufferSize; ++i)
+                {
+                    float phase = (2.0f * juce::MathConstants<float>::pi * frequency * (blockIndex * bufferSize + i)) / sampleRate;
+                    testBuffer.setSample(ch, i, amplitude * std::sin(phase));
+                }
+            }
+            
+            processor.processBlock(testBuffer, midiBuffer);
+        }
+        
+        const float inputRms = amplitude / std::sqrt(2.0f);
+        return juce::Decibels::gainToDecibels(testBuffer.getRMSLevel(0, 0, bufferSize) / inputRms);
+    }
+};
+
+static ResponseCurveTest responseCurveTest;
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include "TestHelpers.h"
+#include <cmath>
+
+class SampleAccurateAutomationTest : public juce::UnitTest
+{
+public:
+    SampleAccurateAutomationTest() : juce::UnitTest("Sample Accurate Automation Test") {}
+    
+    void runTest() override
+    {
+        beginTest("An event inside a block matches splitting the block there");
+        {
+            for (auto* parameterID : { "cutoff", "filterSlope", "filterType", "gain" })
+            {
+                const float value = juce::String(parameterID) == "cutoff" ? 4000.0f
+                                  : juce::String(parameterID) == "gain"   ? -9.0f
+                                                                          : 2.0f;
+                
+                // Reference: the host splits the block itself at the change
+                NewPluginSkeletonAudioProcessor reference;
+                prepare(reference);
+                auto expected = createInput();
+                processRange(reference, expected, 0, eventOffset);
+                TestHelpers::setParameter(reference, parameterID, value);
+                processRange(reference, expected, eventOffset, blockSize - eventOffset);
+                
+                // One block with a timestamped event; the host has already moved the parameter
+                NewPluginSkeletonAudioProcessor processor;
+                prepare(processor);
+                auto actual = createInput();
+                TestHelpers::setParameter(processor, parameterID, value);
+                expect(processor.addParameterEvent(eventOffset, getParameterIndex(processor, parameterID), value));
+                processRange(processor, actual, 0, blockSize);
+                
+                float maxError = 0.0f;
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        maxError = juce::jmax(maxError, std::abs(actual.getSample(ch, i) - expected.getSample(ch, i)));
+                
+                expectLessThan(maxError, 1.0e-5f, juce::String(parameterID) + " should change at the event's sample");
+            }
+        }
+        
+        beginTest("Events past the end of the block still apply");
+        {
+            NewPluginSkeletonAudioProcessor processor;
+            prepare(processor);
+            
+            TestHelpers::setParameter(processor, "gain", -12.0f);
+            processor.addParameterEvent(blockSize * 2, getParameterIndex(processor, "gain"), -12.0f);
+            
+            // Long enough for the 20ms gain ramp to finish
+            float outputPeak = 0.0f;
+            for (int block = 0; block < 16; ++block)
+            {
+                auto buffer = createInput();
+                processRange(processor, buffer, 0, blockSize);
+                outputPeak = buffer.getMagnitude(0, blockSize - 64, 64);
+            }
+            
+            NewPluginSkeletonAudioProcessor unityGain;
+            prepare(unityGain);
+            float referencePeak = 0.0f;
+            for (int block = 0; block < 16; ++block)
+            {
+                auto buffer = createInput();
+                processRange(unityGain, buffer, 0, blockSize);
+                referencePeak = buffer.getMagnitude(0, blockSize - 64, 64);
+            }
+            
+            expectWithinAbsoluteError(juce::Decibels::gainToDecibels(outputPeak / referencePeak), -12.0f, 0.1f);
+        }
+    }
+    
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 1024, numChannels = 2, eventOffset = 300;
+    
+    static void prepare(NewPluginSkeletonAudioProcessor& processor)
+    {
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+    }
+    
+    static juce::AudioBuffer<float> createInput()
+    {
+        // Low enough that the output limiter never engages
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::Random random(0x5eed);
+        
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample(ch, i, 0.1f * (random.nextFloat() * 2.0f - 1.0f));
+        
+        return buffer;
+    }
+    
+    static void processRange(NewPluginSkeletonAudioProcessor& processor, juce::AudioBuffer<float>& buffer,
+                             int start, int length)
+    {
+        juce::AudioBuffer<float> range(buffer.getArrayOfWritePointers(), numChannels, start, length);
+        juce::MidiBuffer midiBuffer;
+        processor.processBlock(range, midiBuffer);
+    }
+    
+    static int getParameterIndex(NewPluginSkeletonAudioProcessor& processor, const juce::String& parameterID)
+    {
+        return processor.parameters.getParameter(parameterID)->getParameterIndex();
+    }
+};
+
+static SampleAccurateAutomationTest sampleAccurateAutomationTest;
\ No newline at end of file
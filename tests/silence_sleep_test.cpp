@@ -0,0 +1,132 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include "TestHelpers.h"
+#include <cmath>
+
+class SilenceSleepTest : public juce::UnitTest
+{
+public:
+    SilenceSleepTest() : juce::UnitTest("Silence Sleep Test") {}
+    
+    void runTest() override
+    {
+        beginTest("Tail length follows the cutoff, resonance and slope");
+        {
+            // The audio thread publishes the tail, so each change needs a block to show up
+            NewPluginSkeletonAudioProcessor processor;
+            TestHelpers::setParameter(processor, "filterSlope", 1.0f);     // 12 dB/oct
+            TestHelpers::setParameter(processor, "cutoff", 1000.0f);
+            prepare(processor);
+            const double tail = processor.getTailLengthSeconds();
+            expect(tail > 0.0, "The filters ring on after the input stops");
+            
+            TestHelpers::setParameter(processor, "cutoff", 100.0f);
+            const double lowCutoffTail = processSilenceForTail(processor);
+            expectWithinAbsoluteError(lowCutoffTail, tail * 10.0, tail * 0.01, "Ten times lower, ten times longer");
+            
+            TestHelpers::setParameter(processor, "resonance", 5.0f);
+            expect(processSilenceForTail(processor) > lowCutoffTail, "Resonance rings on for longer");
+            
+            TestHelpers::setParameter(processor, "filterSlope", 5.0f);  // 48 dB/oct
+            expect(processSilenceForTail(processor) > lowCutoffTail, "More sections ring on for longer");
+        }
+        
+        beginTest("Silent input puts the plugin to sleep once the tail has rung out");
+        {
+            NewPluginSkeletonAudioProcessor processor;
+            TestHelpers::setParameter(processor, "filterSlope", 1.0f);
+            TestHelpers::setParameter(processor, "cutoff", 200.0f);
+            TestHelpers::setParameter(processor, "resonance", 4.0f);
+            prepare(processor);
+            
+            processTone(processor, 8);
+            expect(! processor.isSleeping(), "Not asleep while there's input");
+            
+            // Silence: the output keeps ringing for a while before the plugin sleeps
+            const int tailBlocks = static_cast<int>(std::ceil(processor.getTailLengthSeconds() * sampleRate / blockSize));
+            juce::AudioBuffer<float> buffer(numChannels, blockSize);
+            juce::MidiBuffer midiBuffer;
+            
+            buffer.clear();
+            processor.processBlock(buffer, midiBuffer);
+            expect(buffer.getMagnitude(0, 0, blockSize) > 0.0f, "The resonant tail should still be ringing");
+            expect(! processor.isSleeping(), "Too early to sleep");
+            
+            for (int block = 0; block < tailBlocks + 2 && ! processor.isSleeping(); ++block)
+            {
+                buffer.clear();
+                processor.processBlock(buffer, midiBuffer);
+            }
+            
+            expect(processor.isSleeping(), "Should be asleep once the tail has rung out");
+            
+            // Asleep: silence in, exact silence out
+            for (int block = 0; block < 4; ++block)
+            {
+                buffer.clear();
+                processor.processBlock(buffer, midiBuffer);
+                expectEquals(buffer.getMagnitude(0, 0, blockSize), 0.0f);
+            }
+            
+            // Parameter changes while asleep are picked up on waking, without a crossfade
+            TestHelpers::setParameter(processor, "cutoff", 1000.0f);
+            TestHelpers::setParameter(processor, "resonance", 0.707f);
+            buffer.clear();
+            processor.processBlock(buffer, midiBuffer);
+            expect(processor.isSleeping());
+            
+            NewPluginSkeletonAudioProcessor reference;
+            TestHelpers::setParameter(reference, "filterSlope", 1.0f);
+            TestHelpers::setParameter(reference, "cutoff", 1000.0f);
+            TestHelpers::setParameter(reference, "resonance", 0.707f);
+            prepare(reference);
+            
+            const float wokenLevel = processTone(processor, 8);
+            const float referenceLevel = processTone(reference, 8);
+            
+            expect(! processor.isSleeping(), "Input wakes the plugin up");
+            expectWithinAbsoluteError(wokenLevel, referenceLevel, 1.0e-5f, "Waking up starts from a clean state");
+        }
+    }
+    
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512, numChannels = 2;
+    
+    static void prepare(NewPluginSkeletonAudioProcessor& processor)
+    {
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+    }
+    
+    // Tail length published after one block of silence
+    static double processSilenceForTail(NewPluginSkeletonAudioProcessor& processor)
+    {
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midiBuffer;
+        buffer.clear();
+        processor.processBlock(buffer, midiBuffer);
+        return processor.getTailLengthSeconds();
+    }
+    
+    // RMS of the last of numBlocks blocks of a 500 Hz tone
+    static float processTone(NewPluginSkeletonAudioProcessor& processor, int numBlocks)
+    {
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midiBuffer;
+        
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample(ch, i, 0.25f * std::sin(juce::MathConstants<float>::twoPi * 500.0f
+                                                             * static_cast<float>(block * blockSize + i) / static_cast<float>(sampleRate)));
+            
+            processor.processBlock(buffer, midiBuffer);
+        }
+        
+        return buffer.getRMSLevel(0, 0, blockSize);
+    }
+};
+
+static SilenceSleepTest silenceSleepTest;
\ No newline at end of file
@@ -53,7 +53,7 @@ public:
         }
         
         // Process first block with 6dB slope
-        auto* slopeParam = processor.parameters.getParameter("slope");
+        auto* slopeParam = processor.parameters.getParameter("filterSlope");
         slopeParam->setValueNotifyingHost(0.0f); // 6dB
         
         juce::AudioBuffer<float> block1(testBuffer.getArrayOfWritePointers(), 2, 0, bufferSize);
@@ -61,13 +61,13 @@ public:
         processor.processBlock(block1, midiBuffer);
         
         // Switch to 12dB slope for second block
-        slopeParam->setValueNotifyingHost(0.5f); // 12dB
+        slopeParam->setValueNotifyingHost(0.2f); // 12dB
         
         juce::AudioBuffer<float> block2(testBuffer.getArrayOfWritePointers(), 2, bufferSize, bufferSize);
         processor.processBlock(block2, midiBuffer);
         
         // Switch to 24dB slope for third block
-        slopeParam->setValueNotifyingHost(1.0f); // 24dB
+        slopeParam->setValueNotifyingHost(0.6f); // 24dB
         
         juce::AudioBuffer<float> block3(testBuffer.getArrayOfWritePointers(), 2, bufferSize * 2, bufferSize);
         processor.processBlock(block3, midiBuffer);
@@ -0,0 +1,188 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include "TestHelpers.h"
+#include <cmath>
+
+class StateFormatTest : public juce::UnitTest
+{
+public:
+    StateFormatTest() : juce::UnitTest("State Format Test") {}
+    
+    void runTest() override
+    {
+        beginTest("Binary state round trip");
+        {
+            NewPluginSkeletonAudioProcessor source;
+            TestHelpers::setParameter(source, "cutoff", 2500.0f);
+            TestHelpers::setParameter(source, "resonance", 3.2f);
+            TestHelpers::setParameter(source, "filterSlope", 4.0f);
+            TestHelpers::setParameter(source, "filterType", 1.0f);
+            TestHelpers::setParameter(source, "gain", -6.5f);
+            
+            juce::MemoryBlock state;
+            source.getStateInformation(state);
+            
+            expect(BinaryStateFormat::isBinaryState(state.getData(), static_cast<int>(state.getSize())),
+                   "State should be written in the binary format");
+            expectEquals(static_cast<int>(state.getSize()),
+                         static_cast<int>(BinaryStateFormat::headerSize + source.getParameters().size() * BinaryStateFormat::entrySize),
+                         "One fixed-size entry per parameter");
+            
+            NewPluginSkeletonAudioProcessor restored;
+            restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            
+            for (auto* id : { "cutoff", "resonance", "filterSlope", "filterType", "gain" })
+                expectWithinAbsoluteError(getParameter(restored, id), getParameter(source, id), 1.0e-4f,
+                                          juce::String(id) + " should survive a round trip");
+        }
+        
+        beginTest("XML sessions from earlier versions still load");
+        {
+            NewPluginSkeletonAudioProcessor source;
+            TestHelpers::setParameter(source, "cutoff", 440.0f);
+            TestHelpers::setParameter(source, "filterType", 2.0f);
+            
+            // What getStateInformation used to write
+            juce::MemoryBlock legacyState;
+            auto xml = source.parameters.copyState().createXml();
+            juce::AudioProcessor::copyXmlToBinary(*xml, legacyState);
+            
+            NewPluginSkeletonAudioProcessor restored;
+            restored.setStateInformation(legacyState.getData(), static_cast<int>(legacyState.getSize()));
+            
+            expectWithinAbsoluteError(getParameter(restored, "cutoff"), 440.0f, 1.0e-3f);
+            expectEquals(getParameter(restored, "filterType"), 2.0f);
+        }
+        
+        beginTest("Version 1 slopes are moved to the current choices");
+        {
+            // Version 1 had 6, 12 and 24 dB/oct under the ID "slope", so its index 2 is
+            // now filterSlope's index 3
+            NewPluginSkeletonAudioProcessor source;
+            TestHelpers::setParameter(source, "slope", 2.0f);
+            
+            juce::MemoryBlock state;
+            source.getStateInformation(state);
+            setVersion(state, 1);
+            removeEntry(state, source, "filterSlope");
+            
+            NewPluginSkeletonAudioProcessor restored;
+            restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            expectEquals(getParameter(restored, "filterSlope"), 3.0f, "A binary version 1 state should be upgraded");
+            
+            // XML sessions are all version 1; ones written now carry the current version
+            auto xml = source.parameters.copyState().createXml();
+            xml->removeAttribute("version");
+            xml->removeChildElement(xml->getChildByAttribute("id", "filterSlope"), true);
+            juce::MemoryBlock legacyState;
+            juce::AudioProcessor::copyXmlToBinary(*xml, legacyState);
+            
+            NewPluginSkeletonAudioProcessor restoredFromXml;
+            restoredFromXml.setStateInformation(legacyState.getData(), static_cast<int>(legacyState.getSize()));
+            expectEquals(getParameter(restoredFromXml, "filterSlope"), 3.0f, "An XML session should be upgraded");
+        }
+        
+        beginTest("Version 2 slopes load from the old parameter ID");
+        {
+            // Version 2 saved the current choices, still under "slope"
+            NewPluginSkeletonAudioProcessor source;
+            
+            juce::MemoryBlock state;
+            source.getStateInformation(state);
+            setVersion(state, 2);
+            removeEntry(state, source, "filterSlope");
+            
+            const float savedSlope = 4.0f;   // 36 dB/oct
+            juce::uint32 bits;
+            std::memcpy(&bits, &savedSlope, sizeof(bits));
+            bits = juce::ByteOrder::swapIfBigEndian(bits);
+            std::memcpy(static_cast<char*>(state.getData()) + getEntryOffset(source, "slope") + 4, &bits, sizeof(bits));
+            
+            NewPluginSkeletonAudioProcessor restored;
+            restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            expectEquals(getParameter(restored, "filterSlope"), 4.0f, "A version 2 slope shouldn't be mapped again");
+        }
+        
+        beginTest("Automation on the old slope parameter still switches the slope");
+        {
+            NewPluginSkeletonAudioProcessor processor;
+            
+            TestHelpers::setParameter(processor, "slope", 1.0f);
+            expectEquals(getParameter(processor, "filterSlope"), 1.0f, "12 dB/oct");
+            
+            TestHelpers::setParameter(processor, "slope", 2.0f);
+            expectEquals(getParameter(processor, "filterSlope"), 3.0f, "24 dB/oct");
+            
+            // Loading a session doesn't forward the old parameter's saved value
+            TestHelpers::setParameter(processor, "filterSlope", 5.0f);
+            juce::MemoryBlock state;
+            processor.getStateInformation(state);
+            
+            NewPluginSkeletonAudioProcessor restored;
+            restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            expectEquals(getParameter(restored, "filterSlope"), 5.0f);
+        }
+        
+        beginTest("Unknown entries are skipped and missing parameters reset to defaults");
+        {
+            NewPluginSkeletonAudioProcessor source;
+            TestHelpers::setParameter(source, "cutoff", 5000.0f);
+            
+            juce::MemoryBlock state;
+            source.getStateInformation(state);
+            
+            // Rewrite the first entry (cutoff) as a parameter this version doesn't know
+            auto* bytes = static_cast<char*>(state.getData());
+            const juce::uint32 unknownHash = juce::ByteOrder::swapIfBigEndian(BinaryStateFormat::hashParameterID("notAParameter"));
+            std::memcpy(bytes + BinaryStateFormat::headerSize, &unknownHash, sizeof(unknownHash));
+            
+            NewPluginSkeletonAudioProcessor restored;
+            TestHelpers::setParameter(restored, "cutoff", 100.0f);
+            restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            
+            expectWithinAbsoluteError(getParameter(restored, "cutoff"), 1000.0f, 1.0e-3f,
+                                      "Cutoff wasn't in the state, so it should be back at its default");
+        }
+        
+        beginTest("Truncated states are rejected");
+        {
+            NewPluginSkeletonAudioProcessor source;
+            TestHelpers::setParameter(source, "gain", 6.0f);
+            
+            juce::MemoryBlock state;
+            source.getStateInformation(state);
+            
+            NewPluginSkeletonAudioProcessor restored;
+            restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()) - 3);
+            expectEquals(getParameter(restored, "gain"), 0.0f, "A truncated state shouldn't change anything");
+        }
+    }
+    
+private:
+    static float getParameter(NewPluginSkeletonAudioProcessor& processor, const juce::String& parameterID)
+    {
+        return processor.parameters.getRawParameterValue(parameterID)->load();
+    }
+    
+    // Entries are written in parameter order
+    static size_t getEntryOffset(NewPluginSkeletonAudioProcessor& processor, const juce::String& parameterID)
+    {
+        const auto index = static_cast<size_t>(processor.parameters.getParameter(parameterID)->getParameterIndex());
+        return BinaryStateFormat::headerSize + index * BinaryStateFormat::entrySize;
+    }
+    
+    static void setVersion(juce::MemoryBlock& state, int version)
+    {
+        const juce::uint16 legacyVersion = juce::ByteOrder::swapIfBigEndian(static_cast<juce::uint16>(version));
+        std::memcpy(static_cast<char*>(state.getData()) + 4, &legacyVersion, sizeof(legacyVersion));
+    }
+    
+    // Makes the state look like it was saved before the parameter existed
+    static void removeEntry(juce::MemoryBlock& state, NewPluginSkeletonAudioProcessor& processor, const juce::String& parameterID)
+    {
+        const juce::uint32 unknownHash = juce::ByteOrder::swapIfBigEndian(BinaryStateFormat::hashParameterID("notAParameter"));
+        std::memcpy(static_cast<char*>(state.getData()) + getEntryOffset(processor, parameterID), &unknownHash, sizeof(unknownHash));
+    }
+};
+
+static StateFormatTest stateFormatTest;
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_dsp/juce_dsp.h>
+#include "../Source/PluginProcessor.h"
+#include "TestHelpers.h"
+#include <cmath>
+
+class StereoModeTest : public juce::UnitTest
+{
+public:
+    StereoModeTest() : juce::UnitTest("Stereo Mode Test") {}
+    
+    void runTest() override
+    {
+        beginTest("L/R mode filters the right channel with its own cutoff");
+        {
+            NewPluginSkeletonAudioProcessor linked, independent;
+            
+            for (auto* processor : { &linked, &independent })
+            {
+                TestHelpers::setParameter(*processor, "filterSlope", 1.0f);    // 12 dB/oct
+                TestHelpers::setParameter(*processor, "cutoff", 500.0f);
+            }
+            
+            TestHelpers::setParameter(independent, "stereoMode", 1.0f);
+            TestHelpers::setParameter(independent, "cutoff2", 4000.0f);
+            
+            const auto linkedLevels = processTone(linked, 2000.0, 1.0);
+            const auto levels = processTone(independent, 2000.0, 1.0);
+            
+            expectWithinAbsoluteError(levels.left, linkedLevels.left, 0.01, "The left channel runs the linked filter");
+            expectWithinAbsoluteError(linkedLevels.right, linkedLevels.left, 0.01, "Linked channels are filtered alike");
+            expectGreaterThan(levels.right - levels.left, 20.0, "The right channel's cutoff is above the tone");
+        }
+        
+        beginTest("Mid/Side mode filters the mid and side with their own cutoffs");
+        {
+            NewPluginSkeletonAudioProcessor linked, linkedSide, midSide;
+            
+            for (auto* processor : { &linked, &linkedSide, &midSide })
+                TestHelpers::setParameter(*processor, "filterSlope", 3.0f);    // 24 dB/oct
+                
+            TestHelpers::setParameter(linked, "cutoff", 1000.0f);
+            TestHelpers::setParameter(linkedSide, "cutoff", 8000.0f);
+            TestHelpers::setParameter(midSide, "cutoff", 1000.0f);
+            TestHelpers::setParameter(midSide, "cutoff2", 8000.0f);
+            TestHelpers::setParameter(midSide, "stereoMode", 2.0f);
+            
+            // The same signal in both channels is all mid
+            const auto mid = processTone(midSide, 2000.0, 1.0);
+            const auto linkedMid = processTone(linked, 2000.0, 1.0);
+            expectWithinAbsoluteError(mid.left, linkedMid.left, 0.01, "Mid runs the first cutoff");
+            expectWithinAbsoluteError(mid.right, linkedMid.right, 0.01);
+            
+            // Opposite signals are all side
+            const auto side = processTone(midSide, 2000.0, -1.0);
+            const auto linkedSideLevels = processTone(linkedSide, 2000.0, -1.0);
+            expectWithinAbsoluteError(side.left, linkedSideLevels.left, 0.01, "Side runs the second cutoff");
+            expectWithinAbsoluteError(side.right, linkedSideLevels.right, 0.01);
+            expectGreaterThan(side.left - mid.left, 20.0);
+        }
+        
+        beginTest("The second set's gain applies to the right channel, or the side");
+        {
+            NewPluginSkeletonAudioProcessor linked, independent, midSide;
+            
+            for (auto* processor : { &linked, &independent, &midSide })
+            {
+                TestHelpers::setParameter(*processor, "cutoff", 8000.0f);
+                TestHelpers::setParameter(*processor, "gain2", -12.0f);
+            }
+            
+            TestHelpers::setParameter(independent, "stereoMode", 1.0f);
+            TestHelpers::setParameter(midSide, "stereoMode", 2.0f);
+            
+            const auto linkedLevels = processTone(linked, 500.0, 1.0);
+            expectWithinAbsoluteError(linkedLevels.right, linkedLevels.left, 0.01, "Linked channels ignore the second gain");
+            
+            const auto levels = processTone(independent, 500.0, 1.0);
+            expectWithinAbsoluteError(levels.left, linkedLevels.left, 0.01);
+            expectWithinAbsoluteError(levels.right - levels.left, -12.0, 0.1, "The right channel takes the second gain");
+            
+            // The side is turned down before decoding: all mid is untouched, all side drops 12 dB
+            const auto mid = processTone(midSide, 500.0, 1.0);
+            const auto side = processTone(midSide, 500.0, -1.0);
+            expectWithinAbsoluteError(mid.left, linkedLevels.left, 0.01, "Mid keeps the first gain");
+            expectWithinAbsoluteError(side.left - mid.left, -12.0, 0.1, "Side takes the second gain");
+            expectWithinAbsoluteError(side.right - mid.right, -12.0, 0.1);
+        }
+    }
+    
+private:
+    static constexpr int blockSize = 512;
+    static constexpr double sampleRate = 48000.0;
+    
+    struct Levels
+    {
+        double left = 0.0, right = 0.0;
+    };
+    
+    // Level of each channel in dB, measured over the last second, for a sine in the left
+    // channel and the same sine times rightScale in the right
+    Levels processTone(NewPluginSkeletonAudioProcessor& processor, double frequency, double rightScale)
+    {
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+        
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        
+        const int totalBlocks = static_cast<int>(std::ceil(2.0 * sampleRate / blockSize));
+        const int measuredBlocks = static_cast<int>(std::ceil(sampleRate / blockSize));
+        double sumSquares[2] = {};
+        juce::int64 position = 0;
+        
+        for (int block = 0; block < totalBlocks; ++block)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const auto sample = 0.5 * std::sin(juce::MathConstants<double>::twoPi * frequency
+                                                   * static_cast<double>(position++) / sampleRate);
+                buffer.setSample(0, i, static_cast<float>(sample));
+                buffer.setSample(1, i, static_cast<float>(sample * rightScale));
+            }
+            
+            processor.processBlock(buffer, midi);
+            
+            if (block >= totalBlocks - measuredBlocks)
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        sumSquares[ch] += static_cast<double>(buffer.getSample(ch, i)) * static_cast<double>(buffer.getSample(ch, i));
+        }
+        
+        const auto getDecibels = [&](int ch)
+        {
+            const double rms = std::sqrt(sumSquares[ch] / (measuredBlocks * blockSize));
+            return juce::Decibels::gainToDecibels(rms / (0.5 / std::sqrt(2.0)), -300.0);
+        };
+        
+        return { getDecibels(0), getDecibels(1) };
+    }
+};
+
+static StereoModeTest stereoModeTest;
\ No newline at end of file
@@ -22,10 +22,10 @@ public:
         processor.prepareToPlay(sampleRate, bufferSize);
         
         // Set filter to 12dB/oct slope
-        auto* slopeParam = processor.parameters.getParameter("slope");
+        auto* slopeParam = processor.parameters.getParameter("filterSlope");
         if (slopeParam)
         {
-            slopeParam->setValueNotifyingHost(1.0f / 2.0f); // Index 1 = 12dB
+            slopeParam->setValueNotifyingHost(1.0f / 5.0f); // Index 1 = 12dB
         }
         
         // Set cutoff to 1kHz
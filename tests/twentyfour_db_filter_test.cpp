@@ -22,10 +22,10 @@ public:
         processor.prepareToPlay(sampleRate, bufferSize);
         
         // Set filter to 24dB/oct slope
-        auto* slopeParam = processor.parameters.getParameter("slope");
+        auto* slopeParam = processor.parameters.getParameter("filterSlope");
         if (slopeParam)
         {
-            slopeParam->setValueNotifyingHost(2.0f / 2.0f); // Index 2 = 24dB
+            slopeParam->setValueNotifyingHost(3.0f / 5.0f); // Index 3 = 24dB
         }
         
         // Set cutoff to 1kHz
@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+    Multi-threaded batch rendering.
+
+  ==============================================================================
+*/
+
+#include "BatchRenderer.h"
+#include <algorithm>
+
+//==============================================================================
+WorkStealingQueue::WorkStealingQueue(int numWorkers)
+{
+    for (int i = 0; i < numWorkers; ++i)
+        queues.push_back(std::make_unique<WorkerQueue>());
+}
+
+void WorkStealingQueue::push(int worker, int jobIndex)
+{
+    queues[static_cast<size_t>(worker)]->jobs.push_back(jobIndex);
+}
+
+bool WorkStealingQueue::pop(int worker, int& jobIndex)
+{
+    const auto numQueues = static_cast<int>(queues.size());
+
+    {
+        auto& own = *queues[static_cast<size_t>(worker)];
+        const juce::ScopedLock sl(own.lock);
+
+        if (! own.jobs.empty())
+        {
+            jobIndex = own.jobs.front();
+            own.jobs.pop_front();
+            return true;
+        }
+    }
+
+    // Nothing left of our own: steal from the back of the next non-empty queue
+    for (int offset = 1; offset < numQueues; ++offset)
+    {
+        auto& victim = *queues[static_cast<size_t>((worker + offset) % numQueues)];
+        const juce::ScopedLock sl(victim.lock);
+
+        if (! victim.jobs.empty())
+        {
+            jobIndex = victim.jobs.back();
+            victim.jobs.pop_back();
+            return true;
+        }
+    }
+
+    // Jobs are never added once the workers are running, so empty means done
+    return false;
+}
+
+//==============================================================================
+class BatchRenderer::Worker : public juce::Thread
+{
+public:
+    Worker(int workerIndex, const RenderSettings& settings, WorkStealingQueue& queueToUse,
+           juce::TimeSliceThread& ioThreadToUse, const juce::Array<RenderJob>& jobsToRender,
+           juce::Array<RenderResult>& resultsToFill, juce::CriticalSection& callbackLockToUse,
+           const ProgressCallback& callback)
+        : juce::Thread("Render worker " + juce::String(workerIndex)),
+          index(workerIndex), renderer(settings), queue(queueToUse), ioThread(ioThreadToUse),
+          jobs(jobsToRender), results(resultsToFill), callbackLock(callbackLockToUse), onJobFinished(callback)
+    {
+    }
+
+    ~Worker() override
+    {
+        stopThread(-1);
+    }
+
+    bool initialise(juce::String& error)
+    {
+        return renderer.initialise(error);
+    }
+
+    void run() override
+    {
+        int jobIndex = 0;
+
+        while (! threadShouldExit() && queue.pop(index, jobIndex))
+        {
+            const auto& job = jobs.getReference(jobIndex);
+            auto& result = results.getReference(jobIndex);
+
+            const auto startTime = juce::Time::getMillisecondCounterHiRes();
+            result.audioSeconds = renderer.render(job.inputFile, job.outputFile, ioThread, result.error);
+            result.renderSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+            result.succeeded = result.audioSeconds >= 0.0;
+
+            if (onJobFinished != nullptr)
+            {
+                const juce::ScopedLock sl(callbackLock);
+                onJobFinished(job, result);
+            }
+        }
+    }
+
+private:
+    const int index;
+    FileRenderer renderer;
+    WorkStealingQueue& queue;
+    juce::TimeSliceThread& ioThread;
+    const juce::Array<RenderJob>& jobs;
+    juce::Array<RenderResult>& results;
+    juce::CriticalSection& callbackLock;
+    const ProgressCallback& onJobFinished;
+
+    JUCE_DECLARE_NON_COPYABLE(Worker)
+};
+
+//==============================================================================
+BatchRenderer::BatchRenderer(const RenderSettings& settingsToUse, int numWorkersToUse)
+    : settings(settingsToUse),
+      numWorkers(numWorkersToUse > 0 ? numWorkersToUse : juce::SystemStats::getNumCpus())
+{
+}
+
+juce::Array<RenderResult> BatchRenderer::run(const juce::Array<RenderJob>& jobs, ProgressCallback onJobFinished)
+{
+    juce::Array<RenderResult> results;
+    results.resize(jobs.size());
+
+    const int workersToStart = juce::jmax(1, juce::jmin(numWorkers, jobs.size()));
+
+    // Longest jobs first, dealt round-robin, so the queues start out balanced
+    // and whatever gets stolen at the end is short
+    std::vector<int> order(static_cast<size_t>(jobs.size()));
+    for (int i = 0; i < jobs.size(); ++i)
+        order[static_cast<size_t>(i)] = i;
+
+    std::stable_sort(order.begin(), order.end(), [&jobs](int a, int b)
+    {
+        return jobs.getReference(a).sizeHint > jobs.getReference(b).sizeHint;
+    });
+
+    WorkStealingQueue queue(workersToStart);
+    for (size_t i = 0; i < order.size(); ++i)
+        queue.push(static_cast<int>(i % static_cast<size_t>(workersToStart)), order[i]);
+
+    // Compressed formats make the I/O threads do real work too, so give them
+    // one thread per handful of workers rather than a single shared one
+    const int numIOThreads = juce::jlimit(1, 16, workersToStart / 4);
+    juce::OwnedArray<juce::TimeSliceThread> ioThreads;
+
+    for (int i = 0; i < numIOThreads; ++i)
+        ioThreads.add(new juce::TimeSliceThread("Render I/O " + juce::String(i)))->startThread();
+
+    juce::CriticalSection callbackLock;
+    juce::OwnedArray<Worker> workers;
+
+    for (int i = 0; i < workersToStart; ++i)
+    {
+        auto* worker = workers.add(new Worker(i, settings, queue, *ioThreads[i % numIOThreads],
+                                              jobs, results, callbackLock, onJobFinished));
+        juce::String error;
+
+        if (! worker->initialise(error))
+        {
+            for (auto& result : results)
+                result.error = error;
+
+            return results;
+        }
+    }
+
+    for (auto* worker : workers)
+        worker->startThread();
+
+    for (auto* worker : workers)
+        worker->waitForThreadToExit(-1);
+
+    workers.clear();
+
+    for (auto* ioThread : ioThreads)
+        ioThread->stopThread(1000);
+
+    return results;
+}
@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    Multi-threaded batch rendering.
+
+    Every worker thread owns a FileRenderer (and so its own processor), so
+    workers never share DSP state or locks while processing. Jobs are spread
+    over per-worker queues, longest files first. A worker takes work from the
+    front of its own queue and, once that runs dry, steals from the back of
+    the others, so uneven file lengths don't leave cores idle at the end of
+    a batch. Disk I/O runs on a small pool of TimeSliceThreads through
+    bounded buffers.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "FileRenderer.h"
+#include <deque>
+#include <functional>
+
+//==============================================================================
+struct RenderJob
+{
+    juce::File inputFile, outputFile;
+    juce::int64 sizeHint = 0;   // Used to schedule the longest jobs first
+};
+
+struct RenderResult
+{
+    bool succeeded = false;
+    juce::String error;
+    double audioSeconds = 0.0;  // Length of the input
+    double renderSeconds = 0.0; // Wall-clock time spent rendering it
+};
+
+//==============================================================================
+/**
+    A set of per-worker job queues with work stealing.
+
+    Each queue has its own lock, which is only ever contended by a thief, so
+    workers going through their own jobs don't serialise on a shared queue.
+*/
+class WorkStealingQueue
+{
+public:
+    explicit WorkStealingQueue(int numWorkers);
+
+    /** Adds a job to a worker's queue. Not thread-safe against pop(): fill before starting. */
+    void push(int worker, int jobIndex);
+
+    /** Takes the next job for a worker: its own front first, then another queue's back.
+        Returns false once every queue is empty.
+    */
+    bool pop(int worker, int& jobIndex);
+
+private:
+    struct WorkerQueue
+    {
+        juce::CriticalSection lock;
+        std::deque<int> jobs;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+    JUCE_DECLARE_NON_COPYABLE(WorkStealingQueue)
+};
+
+//==============================================================================
+class BatchRenderer
+{
+public:
+    using ProgressCallback = std::function<void(const RenderJob&, const RenderResult&)>;
+
+    /** numWorkers <= 0 uses one worker per CPU core. */
+    BatchRenderer(const RenderSettings& settings, int numWorkers);
+
+    /** Renders every job and returns a result for each one, in the same order.
+        onJobFinished is called from the worker threads, serialised by a lock.
+    */
+    juce::Array<RenderResult> run(const juce::Array<RenderJob>& jobs, ProgressCallback onJobFinished);
+
+    int getNumWorkers() const noexcept   { return numWorkers; }
+
+private:
+    class Worker;
+
+    const RenderSettings& settings;
+    int numWorkers;
+
+    JUCE_DECLARE_NON_COPYABLE(BatchRenderer)
+};
@@ -0,0 +1,275 @@
+/*
+  ==============================================================================
+
+    Renders audio files through one NewPluginSkeletonAudioProcessor.
+
+  ==============================================================================
+*/
+
+#include "FileRenderer.h"
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+
+namespace
+{
+    // Bounded read-ahead and write-behind, in processing blocks
+    constexpr int ioBufferBlocks = 4;
+
+    // Numbers are taken in the parameter's own units (or as a choice index),
+    // anything else is matched against the parameter's text, e.g. "Band-pass"
+    float parseNormalisedValue(const juce::RangedAudioParameter& parameter, const juce::String& valueText)
+    {
+        const auto text = valueText.trim();
+        const bool isNumber = text.containsOnly("0123456789.-+eE") && text.containsAnyOf("0123456789");
+
+        return isNumber ? parameter.convertTo0to1(text.getFloatValue())
+                        : parameter.getValueForText(text);
+    }
+}
+
+//==============================================================================
+FileRenderer::FileRenderer(const RenderSettings& settingsToUse)
+    : settings(settingsToUse)
+{
+    formatManager.registerBasicFormats();
+}
+
+bool FileRenderer::initialise(juce::String& error)
+{
+    if (settings.presetFile != juce::File())
+    {
+        auto xml = juce::parseXML(settings.presetFile);
+
+        if (xml == nullptr || ! xml->hasTagName(processor.parameters.state.getType()))
+        {
+            error = "Couldn't read preset " + settings.presetFile.getFullPathName();
+            return false;
+        }
+
+        processor.loadXmlState(*xml);
+    }
+
+    for (const auto& parameterID : settings.parameterValues.getAllKeys())
+    {
+        auto* parameter = processor.parameters.getParameter(parameterID);
+
+        if (parameter == nullptr)
+        {
+            error = "Unknown parameter --" + parameterID + " (see --list-parameters)";
+            return false;
+        }
+
+        parameter->setValueNotifyingHost(parseNormalisedValue(*parameter, settings.parameterValues[parameterID]));
+    }
+
+    if (settings.automationFile != juce::File() && ! loadAutomation(error))
+        return false;
+
+    processor.setNonRealtime(true);
+    return true;
+}
+
+bool FileRenderer::loadAutomation(juce::String& error)
+{
+    if (! settings.automationFile.existsAsFile())
+    {
+        error = "Couldn't read automation " + settings.automationFile.getFullPathName();
+        return false;
+    }
+
+    const auto lines = juce::StringArray::fromLines(settings.automationFile.loadFileAsString());
+
+    for (int lineIndex = 0; lineIndex < lines.size(); ++lineIndex)
+    {
+        const auto line = lines[lineIndex].trim();
+
+        if (line.isEmpty() || line.startsWithChar('#'))
+            continue;
+
+        const auto tokens = juce::StringArray::fromTokens(line, " \t", "\"");
+        const auto lineName = settings.automationFile.getFileName() + ":" + juce::String(lineIndex + 1);
+
+        if (tokens.size() < 3 || ! tokens[0].containsOnly("0123456789.eE+-"))
+        {
+            error = lineName + ": expected <seconds> <parameter ID> <value>";
+            return false;
+        }
+
+        auto* parameter = processor.parameters.getParameter(tokens[1]);
+
+        if (parameter == nullptr)
+        {
+            error = lineName + ": unknown parameter " + tokens[1] + " (see --list-parameters)";
+            return false;
+        }
+
+        const auto valueText = tokens.joinIntoString(" ", 2).unquoted();
+        automation.push_back({ juce::jmax(0.0, tokens[0].getDoubleValue()), parameter,
+                               parameter->convertFrom0to1(parseNormalisedValue(*parameter, valueText)) });
+    }
+
+    // Points at the same time keep their order in the file
+    std::stable_sort(automation.begin(), automation.end(),
+                     [](const auto& a, const auto& b) { return a.seconds < b.seconds; });
+
+    // Every file starts from the preset and command line values, not wherever the
+    // last file's automation left them
+    for (const auto& point : automation)
+    {
+        const bool alreadyStored = std::any_of(automatedStartValues.begin(), automatedStartValues.end(),
+                                               [&](const auto& stored) { return stored.first == point.parameter; });
+
+        if (! alreadyStored)
+            automatedStartValues.emplace_back(point.parameter, point.parameter->getValue());
+    }
+
+    return true;
+}
+
+double FileRenderer::render(const juce::File& inputFile, const juce::File& outputFile,
+                            juce::TimeSliceThread& ioThread, juce::String& error)
+{
+    const int blockSize = settings.blockSize;
+    auto* sourceReader = formatManager.createReaderFor(inputFile);
+
+    if (sourceReader == nullptr)
+    {
+        error = "Couldn't open " + inputFile.getFullPathName();
+        return -1.0;
+    }
+
+    // Reads ahead on the I/O thread, and waits for it rather than returning silence if it falls behind
+    juce::BufferingAudioReader reader(sourceReader, ioThread, blockSize * ioBufferBlocks);
+    reader.setReadTimeout(-1);
+
+    const auto numChannels = static_cast<int>(reader.numChannels);
+    const auto sampleRate = reader.sampleRate;
+
+    // Set up the processor exactly as a host would, with the file's channel layout
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+    layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+
+    if (! processor.setBusesLayout(layout))
+    {
+        error = "Unsupported channel count: " + juce::String(numChannels);
+        return -1.0;
+    }
+
+    for (const auto& [parameter, startValue] : automatedStartValues)
+        parameter->setValueNotifyingHost(startValue);
+
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    auto* format = formatManager.findFormatForFileExtension(outputFile.getFileExtension());
+
+    if (format == nullptr)
+    {
+        error = "Unsupported output format: " + outputFile.getFileName();
+        return -1.0;
+    }
+
+    auto bitsPerSample = settings.bitsPerSample > 0 ? settings.bitsPerSample : static_cast<int>(reader.bitsPerSample);
+
+    if (! format->getPossibleBitDepths().contains(bitsPerSample))
+        bitsPerSample = format->getPossibleBitDepths().getLast();
+
+    outputFile.deleteFile();
+    std::unique_ptr<juce::OutputStream> stream(outputFile.createOutputStream());
+
+    if (stream == nullptr)
+    {
+        error = "Couldn't write " + outputFile.getFullPathName();
+        return -1.0;
+    }
+
+    auto* formatWriter = format->createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(numChannels),
+                                                 bitsPerSample, reader.metadataValues, 0);
+
+    if (formatWriter == nullptr)
+    {
+        error = "Couldn't create a " + format->getFormatName() + " writer for " + outputFile.getFullPathName();
+        return -1.0;
+    }
+
+    stream.release(); // Now owned by the writer
+
+    // Flushed by the I/O thread; write() refuses blocks while the buffer is full
+    auto writer = std::make_unique<juce::AudioFormatWriter::ThreadedWriter>(formatWriter, ioThread,
+                                                                            blockSize * ioBufferBlocks);
+
+    // The output is shifted back by the reported latency so it lines up with the input,
+    // and the filter's tail is rendered past the end of the file
+    const auto latency = static_cast<juce::int64>(processor.getLatencySamples());
+    const auto tail = static_cast<juce::int64>(std::ceil(processor.getTailLengthSeconds() * sampleRate));
+    const auto inputLength = reader.lengthInSamples;
+    const auto totalLength = inputLength + latency + tail;
+
+    std::vector<const float*> channelPointers(static_cast<size_t>(numChannels));
+    size_t nextPoint = 0;
+
+    for (juce::int64 position = 0; position < totalLength; position += blockSize)
+    {
+        const auto numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize), totalLength - position));
+
+        // Reads past the end of the file are filled with silence
+        buffer.setSize(numChannels, numSamples, false, false, true);
+        reader.read(&buffer, 0, numSamples, position, true, true);
+
+        // Automation inside this block goes in as timestamped events, so the processor
+        // splits the block at each point. Points that don't fit in a full queue wait
+        // for the start of the next block.
+        const auto firstPoint = nextPoint;
+
+        for (; nextPoint < automation.size(); ++nextPoint)
+        {
+            const auto& point = automation[nextPoint];
+            const auto pointPosition = static_cast<juce::int64>(std::llround(point.seconds * sampleRate));
+
+            if (pointPosition >= position + numSamples
+                || ! processor.addParameterEvent(static_cast<int>(juce::jmax(static_cast<juce::int64>(0), pointPosition - position)),
+                                                 point.parameter->getParameterIndex(), point.rawValue))
+                break;
+        }
+
+        processor.processBlock(buffer, midiBuffer);
+
+        // Then the parameters themselves move, as a host would, so the next block reads
+        // the values the events left off at
+        for (auto i = firstPoint; i < nextPoint; ++i)
+            automation[i].parameter->setValueNotifyingHost(automation[i].parameter->convertTo0to1(automation[i].rawValue));
+
+        const auto skip = static_cast<int>(juce::jlimit(static_cast<juce::int64>(0), static_cast<juce::int64>(numSamples), latency - position));
+
+        if (skip == numSamples)
+            continue;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            channelPointers[static_cast<size_t>(ch)] = buffer.getReadPointer(ch, skip);
+
+        // Back-pressure: wait for the I/O thread to drain the write buffer
+        while (! writer->write(channelPointers.data(), numSamples - skip))
+            juce::Thread::sleep(1);
+    }
+
+    writer.reset();
+    processor.releaseResources();
+
+    return static_cast<double>(inputLength) / sampleRate;
+}
+
+void FileRenderer::listParameters(std::ostream& stream)
+{
+    NewPluginSkeletonAudioProcessor processor;
+
+    for (auto* parameter : processor.getParameters())
+    {
+        if (auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter))
+        {
+            stream << "  --" << withID->paramID << "  (" << withID->getName(64)
+                   << ", default " << withID->getText(withID->getDefaultValue(), 64) << ")\n";
+        }
+    }
+}
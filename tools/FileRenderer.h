@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    Renders audio files through one NewPluginSkeletonAudioProcessor.
+
+    Each FileRenderer owns its processor and buffers and is reused for every
+    file it renders, so a batch needs one per worker thread and nothing is
+    shared between them. Reading and writing go through bounded background
+    buffers (BufferingAudioReader / AudioFormatWriter::ThreadedWriter) on the
+    TimeSliceThread passed in, so disk I/O overlaps with processing.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include <iosfwd>
+#include <vector>
+
+//==============================================================================
+/** Parameter and format settings applied to every file of a render. */
+struct RenderSettings
+{
+    juce::File presetFile;
+    juce::StringPairArray parameterValues; // parameter ID -> value text
+    juce::File automationFile;             // Timestamped parameter changes, see FileRenderer::initialise()
+    int blockSize = 8192;
+    int bitsPerSample = 0;                 // 0 = same as the input
+};
+
+//==============================================================================
+class FileRenderer
+{
+public:
+    explicit FileRenderer(const RenderSettings& settingsToUse);
+
+    /** Applies the preset and command line parameters, and reads the automation file:
+        one point per line, "<seconds> <parameter ID> <value>" (e.g. "2.5 cutoff 800"),
+        with blank lines and lines starting with # skipped. Call once before rendering.
+    */
+    bool initialise(juce::String& error);
+
+    /** Renders one file. ioThread must be running; it services the read-ahead and
+        write-behind buffers. Returns the length of the input in seconds, or a
+        negative value with error set if the file couldn't be rendered.
+    */
+    double render(const juce::File& inputFile, const juce::File& outputFile,
+                  juce::TimeSliceThread& ioThread, juce::String& error);
+
+    /** Prints the parameter IDs that can be set on the command line. */
+    static void listParameters(std::ostream& stream);
+
+private:
+    // A change at a time into each file, and the raw value it takes the parameter to
+    struct AutomationPoint
+    {
+        double seconds = 0.0;
+        juce::RangedAudioParameter* parameter = nullptr;
+        float rawValue = 0.0f;
+    };
+
+    bool loadAutomation(juce::String& error);
+
+    const RenderSettings& settings;
+    juce::AudioFormatManager formatManager;
+    NewPluginSkeletonAudioProcessor processor;
+    juce::AudioBuffer<float> buffer;
+    juce::MidiBuffer midiBuffer;
+    std::vector<AutomationPoint> automation;  // In time order
+    std::vector<std::pair<juce::RangedAudioParameter*, float>> automatedStartValues;  // Restored for each file
+
+    JUCE_DECLARE_NON_COPYABLE(FileRenderer)
+};
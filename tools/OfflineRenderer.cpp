@@ -0,0 +1,248 @@
+/*
+  ==============================================================================
+
+    Headless offline renderer.
+
+    Streams audio files through NewPluginSkeletonAudioProcessor without a
+    host or an editor and writes the results, running as fast as the CPU
+    allows. Parameters come from a preset XML (as saved by the editor) and/or
+    from the command line; command line values are applied on top of the
+    preset. An automation file adds sample-accurate parameter changes over
+    time. Batches are spread over all cores by BatchRenderer.
+
+    Usage:
+        MyAwesomePlugin_Render [options] <input> <output>
+        MyAwesomePlugin_Render [options] --output-dir <dir> <input or dir>...
+
+  ==============================================================================
+*/
+
+#include "BatchRenderer.h"
+#include <iostream>
+
+namespace
+{
+    struct CommandLine
+    {
+        RenderSettings settings;
+        juce::StringArray files;
+        juce::File outputDirectory;
+        juce::String outputExtension;   // Empty = same as each input
+        int numWorkers = 0;             // 0 = one per core
+        bool listOnly = false;
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: MyAwesomePlugin_Render [options] <input> <output>\n"
+                     "       MyAwesomePlugin_Render [options] --output-dir <dir> <input or dir>...\n"
+                     "\n"
+                     "Renders WAV/FLAC/AIFF files through Franky's Filters.\n"
+                     "\n"
+                     "Options:\n"
+                     "  --preset <file.xml>   Load parameters from a preset saved by the plugin\n"
+                     "  --<parameter> <value> Set a parameter, e.g. --cutoff 800 --filterSlope \"24 dB/oct\"\n"
+                     "                        Numbers are in the parameter's units (choices take an index)\n"
+                     "  --automation <file>   Timed parameter changes, one per line: <seconds> <parameter> <value>\n"
+                     "  --output-dir <dir>    Render every input (or every audio file in an input\n"
+                     "                        directory) into <dir>, keeping the file names\n"
+                     "  --format <ext>        Output format for --output-dir, e.g. wav or flac\n"
+                     "  --jobs <n>            Number of worker threads (default: one per core)\n"
+                     "  --block-size <n>      Samples per processBlock call (default 8192)\n"
+                     "  --bits <n>            Output bit depth (default: same as the input)\n"
+                     "  --list-parameters     Print the available parameters and exit\n";
+    }
+
+    bool parseArguments(const juce::StringArray& args, CommandLine& commandLine, juce::String& error)
+    {
+        const auto cwd = juce::File::getCurrentWorkingDirectory();
+        auto& settings = commandLine.settings;
+
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& arg = args[i];
+
+            if (arg == "--help" || arg == "-h")
+                return false;
+
+            if (arg == "--list-parameters")
+            {
+                commandLine.listOnly = true;
+                continue;
+            }
+
+            if (! arg.startsWith("--"))
+            {
+                commandLine.files.add(arg);
+                continue;
+            }
+
+            if (i + 1 >= args.size())
+            {
+                error = "Missing value for " + arg;
+                return false;
+            }
+
+            const auto value = args[++i];
+
+            if (arg == "--preset")
+                settings.presetFile = cwd.getChildFile(value);
+            else if (arg == "--automation")
+                settings.automationFile = cwd.getChildFile(value);
+            else if (arg == "--output-dir")
+                commandLine.outputDirectory = cwd.getChildFile(value);
+            else if (arg == "--format")
+                commandLine.outputExtension = "." + value.trimCharactersAtStart(".");
+            else if (arg == "--jobs")
+                commandLine.numWorkers = juce::jmax(1, value.getIntValue());
+            else if (arg == "--block-size")
+                settings.blockSize = juce::jlimit(32, 1 << 20, value.getIntValue());
+            else if (arg == "--bits")
+                settings.bitsPerSample = value.getIntValue();
+            else
+                settings.parameterValues.set(arg.substring(2), value);
+        }
+
+        return true;
+    }
+
+    bool collectJobs(const CommandLine& commandLine, juce::Array<RenderJob>& jobs, juce::String& error)
+    {
+        const auto cwd = juce::File::getCurrentWorkingDirectory();
+
+        // Single file: <input> <output>
+        if (commandLine.outputDirectory == juce::File())
+        {
+            if (commandLine.files.size() != 2)
+            {
+                error = "Expected an input and an output file, or --output-dir";
+                return false;
+            }
+
+            jobs.add({ cwd.getChildFile(commandLine.files[0]), cwd.getChildFile(commandLine.files[1]), 0 });
+            return true;
+        }
+
+        if (! commandLine.outputDirectory.createDirectory())
+        {
+            error = "Couldn't create " + commandLine.outputDirectory.getFullPathName();
+            return false;
+        }
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        juce::Array<juce::File> inputs;
+
+        for (const auto& path : commandLine.files)
+        {
+            const auto file = cwd.getChildFile(path);
+
+            if (file.isDirectory())
+                file.findChildFiles(inputs, juce::File::findFiles, false, formatManager.getWildcardForAllFormats());
+            else
+                inputs.add(file);
+        }
+
+        for (const auto& input : inputs)
+        {
+            const auto extension = commandLine.outputExtension.isNotEmpty() ? commandLine.outputExtension
+                                                                             : input.getFileExtension();
+            const auto output = commandLine.outputDirectory.getChildFile(input.getFileNameWithoutExtension() + extension);
+
+            if (output == input)
+            {
+                error = "Refusing to overwrite input " + input.getFullPathName();
+                return false;
+            }
+
+            jobs.add({ input, output, input.getSize() });
+        }
+
+        if (jobs.isEmpty())
+        {
+            error = "No input files";
+            return false;
+        }
+
+        return true;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(juce::CharPointer_UTF8(argv[i]));
+
+    CommandLine commandLine;
+    juce::String error;
+
+    if (! parseArguments(args, commandLine, error))
+    {
+        if (error.isNotEmpty())
+            std::cerr << error << "\n\n";
+
+        printUsage();
+        return error.isNotEmpty() ? 1 : 0;
+    }
+
+    if (commandLine.listOnly)
+    {
+        FileRenderer::listParameters(std::cout);
+        return 0;
+    }
+
+    juce::Array<RenderJob> jobs;
+
+    if (! collectJobs(commandLine, jobs, error))
+    {
+        std::cerr << error << "\n\n";
+        printUsage();
+        return 1;
+    }
+
+    BatchRenderer batchRenderer(commandLine.settings, commandLine.numWorkers);
+    int numFinished = 0;
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    auto results = batchRenderer.run(jobs, [&numFinished, &jobs](const RenderJob& job, const RenderResult& result)
+    {
+        ++numFinished;
+        std::cout << "[" << numFinished << "/" << jobs.size() << "] ";
+
+        if (result.succeeded)
+            std::cout << job.outputFile.getFullPathName() << " ("
+                      << juce::String(result.audioSeconds / juce::jmax(result.renderSeconds, 1.0e-3), 1) << "x real time)\n";
+        else
+            std::cout << "FAILED " << job.inputFile.getFullPathName() << ": " << result.error << "\n";
+    });
+
+    const auto elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+    int numFailed = 0;
+    double totalAudioSeconds = 0.0;
+
+    for (const auto& result : results)
+    {
+        if (result.succeeded)
+            totalAudioSeconds += result.audioSeconds;
+        else
+            ++numFailed;
+    }
+
+    // Jobs that never ran (e.g. a bad preset) haven't been reported yet
+    if (numFinished == 0 && numFailed > 0)
+        std::cerr << results.getReference(0).error << "\n";
+
+    std::cout << "Rendered " << (results.size() - numFailed) << " of " << results.size() << " files in "
+              << juce::String(elapsedSeconds, 2) << "s on " << juce::jmin(batchRenderer.getNumWorkers(), jobs.size())
+              << " threads (" << juce::String(totalAudioSeconds / juce::jmax(elapsedSeconds, 1.0e-3), 1)
+              << "x real time)\n";
+
+    return numFailed == 0 ? 0 : 1;
+}